@@ -0,0 +1,388 @@
+/*
+sgp4_bench.cpp
+
+Host benchmark for the Sgp4 library. It times the three workloads the tracker runs on the ESP32:
+  - single point propagation (Sgp4::findsat), with all outputs and with elevation only
+  - 24 hour pass search (Sgp4::initpredpoint + Sgp4::nextpass)
+  - 24 hours of the 1 Hz loop reading the next 10 passes from a PassPredictor
+  - 1 second track generation over the first pass (what the Az/El and polar pages draw),
+    once with findsat per sample, once in a single Sgp4::propagateRange call and once from an
+    Sgp4Ephemeris fitted over the pass
+against a fixed set of TLEs, so hot path changes can be compared before they land on the board.
+
+Usage: sgp4_bench [repeat]
+  repeat  number of runs per workload, the fastest one is reported (default 5)
+
+The raw kernels (sgp4 and the single precision sgp4f) are timed as well, and a second table
+gives the largest sgp4f - sgp4 difference over +-3 days from epoch (the error budget of sgp4f).
+A third table compares the Sgp4Ephemeris of the first pass with findsat every second.
+The last line compares the incremental earth rotation of a sweepcontext with teme2ecef per sample.
+
+Every workload also prints a checksum of its results. Timings may change between two builds,
+the checksums should not (unless the change is meant to alter the numbers).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>  // not <chrono>/<time.h>: glibc declares a global 'daylight' that clashes with visibletype
+#include <Sgp4.h>
+
+struct benchsat
+{
+  const char* name;
+  const char* line1;
+  const char* line2;
+};
+
+// Fixed element sets (epoch 2024-01-01 12:00 UTC) covering LEO, polar LEO, elliptical LEO and GEO
+static const benchsat sats[] = {
+  {"ISS (ZARYA)",
+   "1 25544U 98067A   24001.50000000  .00016717  00000-0  30571-3 0  9993",
+   "2 25544  51.6416 208.9163 0006317  69.9862  25.2906 15.50103472431236"},
+  {"NOAA 19",
+   "1 33591U 09005A   24001.50000000  .00000210  00000-0  13769-3 0  9999",
+   "2 33591  99.1037  68.2714 0013788 276.1620  83.7993 14.12939837763452"},
+  {"FO-29",
+   "1 24278U 96046B   24001.50000000  .00000041  00000-0  39645-4 0  9996",
+   "2 24278  98.5347 283.2014 0348600 173.4529 186.6919 13.53227419352134"},
+  {"QO-100",
+   "1 43700U 18090A   24001.50000000 -.00000137  00000-0  00000+0 0  9995",
+   "2 43700   0.0163 258.6254 0001654 207.2468 199.9128  1.00271016 18739"},
+};
+
+// Observer of the tracker (config.h)
+#define SITE_LAT 46.4666463
+#define SITE_LON 6.8615008
+#define SITE_ALT 500.0
+
+#define START_UNIX 1704132000UL      // 2024-01-01 18:00 UTC, 6 hours after epoch
+#define PROPAGATE_STEP 10            // seconds between findsat samples
+#define PROPAGATE_SPAN 86400         // seconds covered by the findsat sweep
+#define TRACK_FALLBACK 600           // seconds tracked when no pass is found
+#define TRACK_MAX 8192               // samples in the propagateRange buffer
+#define ACCURACY_SPAN (SGP4_FLOAT_SPAN / 1440.0) // days on each side of epoch compared by accuracy(), where sgp4f is used
+#define ACCURACY_STEP 1.0            // minutes between accuracy samples
+#define SWEEP_SAMPLES 86400          // 1 second samples compared by sweepaccuracy()
+
+typedef double (*benchfunc)(Sgp4& sat, long& calls);
+
+static double nowUs()
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1e6 + tv.tv_usec;
+}
+
+static void initsat(Sgp4& sat, const benchsat& s)
+{
+  // twoline2rv modifies the lines in place, so hand it a copy
+  char line1[130];
+  char line2[130];
+  snprintf(line1, sizeof(line1), "%s", s.line1);
+  snprintf(line2, sizeof(line2), "%s", s.line2);
+  sat.init(s.name, line1, line2);
+  sat.site(SITE_LAT, SITE_LON, SITE_ALT);
+}
+
+// findsat over one day
+static double benchPropagate(Sgp4& sat, long& calls)
+{
+  double sum = 0.0;
+  calls = 0;
+  for (unsigned long t = START_UNIX; t < START_UNIX + PROPAGATE_SPAN; t += PROPAGATE_STEP) {
+    sat.findsat(t);
+    sum += sat.satEl + sat.satAz + sat.satLat + sat.satLon;
+    calls++;
+  }
+  return sum;
+}
+
+// the double and float kernels alone, same one day sweep
+static double benchKernel(Sgp4& sat, long& calls)
+{
+  double r[3], v[3];
+  double tstart = (getJulianFromUnix(START_UNIX) - sat.satrec.jdsatepoch) * 1440.0;
+  double sum = 0.0;
+  calls = 0;
+  for (long i = 0; i < PROPAGATE_SPAN / PROPAGATE_STEP; i++) {
+    sgp4(wgs84, sat.satrec, tstart + i * PROPAGATE_STEP / 60.0, r, v);
+    sum += r[0] + r[1] + r[2];
+    calls++;
+  }
+  return sum;
+}
+
+static double benchKernelf(Sgp4& sat, long& calls)
+{
+  double r[3], v[3];
+  double tstart = (getJulianFromUnix(START_UNIX) - sat.satrec.jdsatepoch) * 1440.0;
+  double sum = 0.0;
+  calls = 0;
+  for (long i = 0; i < PROPAGATE_SPAN / PROPAGATE_STEP; i++) {
+    sgp4f(wgs84, sat.satrec, tstart + i * PROPAGATE_STEP / 60.0, r, v);
+    sum += r[0] + r[1] + r[2];
+    calls++;
+  }
+  return sum;
+}
+
+// same sweep, only the topocentric output (what an elevation sweep reads)
+static double benchElevation(Sgp4& sat, long& calls)
+{
+  double sum = 0.0;
+  calls = 0;
+  for (unsigned long t = START_UNIX; t < START_UNIX + PROPAGATE_SPAN; t += PROPAGATE_STEP) {
+    sat.findsat(t, topocentric);
+    sum += sat.satEl + sat.satAz;
+    calls++;
+  }
+  return sum;
+}
+
+// all passes in the next 24 hours
+static double benchPasses(Sgp4& sat, long& calls)
+{
+  passinfo overpass;
+  double jdend = getJulianFromUnix(START_UNIX) + 1.0;
+  double sum = 0.0;
+  calls = 0;
+
+  if (!sat.initpredpoint(START_UNIX, 0.0)) {
+    return -1.0;
+  }
+  while (sat.nextpass(&overpass, 100)) {
+    if (overpass.jdstart > jdend) break;
+    sum += (overpass.jdstart - 2460000.0) + (overpass.jdstop - 2460000.0) + overpass.maxelevation;
+    calls++;
+  }
+  return sum;
+}
+
+// the 1 Hz loop over 24 hours, asking the pass list for the next 10 passes every second
+static double benchPassList(Sgp4& sat, long& calls)
+{
+  static PassPredictor predictor;
+  double last = 0.0;
+  double sum = 0.0;
+  calls = 0;
+
+  predictor.begin(0.0);
+  for (unsigned long t = START_UNIX; t < START_UNIX + 86400UL; t++) {
+    predictor.update(sat, t, 10);
+    const passinfo* next = predictor.get(0);
+    if (next != NULL && next->jdstart != last) {
+      last = next->jdstart;
+      sum += (next->jdstart - 2460000.0) + (next->jdstop - 2460000.0) + next->maxelevation;
+    }
+    calls++;
+  }
+  return sum;
+}
+
+// 1 second track over the first pass, the way the plot pages sample it
+static double benchTrack(Sgp4& sat, long& calls)
+{
+  passinfo overpass;
+  unsigned long start = START_UNIX;
+  unsigned long stop = START_UNIX + TRACK_FALLBACK;
+  double sum = 0.0;
+  calls = 0;
+
+  if (sat.initpredpoint(START_UNIX, 0.0) && sat.nextpass(&overpass, 100)) {
+    start = getUnixFromJulian(overpass.jdstart);
+    stop = getUnixFromJulian(overpass.jdstop);
+  }
+  for (unsigned long t = start; t <= stop; t++) {
+    sat.findsat(t);
+    sum += sat.satEl + sat.satAz;
+    calls++;
+  }
+  return sum;
+}
+
+// same window as benchTrack, batched through propagateRange
+static double benchBatch(Sgp4& sat, long& calls)
+{
+  static float az[TRACK_MAX], el[TRACK_MAX], range[TRACK_MAX], lat[TRACK_MAX], lon[TRACK_MAX];
+  trackbuffer track = {az, el, range, lat, lon, NULL};
+  passinfo overpass;
+  unsigned long start = START_UNIX;
+  unsigned long stop = START_UNIX + TRACK_FALLBACK;
+  double sum = 0.0;
+
+  if (sat.initpredpoint(START_UNIX, 0.0) && sat.nextpass(&overpass, 100)) {
+    start = getUnixFromJulian(overpass.jdstart);
+    stop = getUnixFromJulian(overpass.jdstop);
+  }
+  int count = (int)(stop - start) + 1;
+  if (count > TRACK_MAX) count = TRACK_MAX;
+  calls = sat.propagateRange(start, 1.0, count, track, alloutputs);
+  for (long i = 0; i < calls; i++) {
+    sum += el[i] + az[i];
+  }
+  return sum;
+}
+
+// same window as benchTrack, fitted once and evaluated every second
+static double benchEphemeris(Sgp4& sat, long& calls)
+{
+  static Sgp4Ephemeris ephem;
+  passinfo overpass;
+  unsigned long start = START_UNIX;
+  unsigned long stop = START_UNIX + TRACK_FALLBACK;
+  double sum = 0.0;
+  calls = 0;
+
+  if (sat.initpredpoint(START_UNIX, 0.0) && sat.nextpass(&overpass, 100)) {
+    start = getUnixFromJulian(overpass.jdstart);
+    stop = getUnixFromJulian(overpass.jdstop);
+  }
+  if (!ephem.fit(sat, start, stop)) return -1.0;
+  for (unsigned long t = start; t <= stop; t++) {
+    ephem.evaluate(t);
+    sum += ephem.satEl + ephem.satAz;
+    calls++;
+  }
+  return sum;
+}
+
+static void run(const benchsat& s, const char* label, benchfunc f, int repeat)
+{
+  double best = 0.0;
+  double sum = 0.0;
+  long calls = 0;
+
+  for (int r = 0; r < repeat; r++) {
+    Sgp4 sat;
+    initsat(sat, s);
+    double t0 = nowUs();
+    sum = f(sat, calls);
+    double dt = nowUs() - t0;
+    if (r == 0 || dt < best) best = dt;
+  }
+
+  printf("%-12s %-10s %8ld %12.1f %12.3f   %.6f\n", s.name, label, calls, best / 1000.0,
+         calls > 0 ? best / calls : 0.0, sum);
+}
+
+// largest difference between sgp4f and sgp4 over +-ACCURACY_SPAN days from epoch
+static void accuracy(const benchsat& s)
+{
+  Sgp4 sat;
+  double r[3], v[3], rf[3], vf[3], razel[3], razelf[3];
+  double drmax = 0.0, dvmax = 0.0, dazmax = 0.0, delmax = 0.0;
+  double siteLatRad = SITE_LAT * pi / 180.0;
+  double siteLonRad = SITE_LON * pi / 180.0;
+  double siteAltKm = SITE_ALT / 1000.0;
+
+  initsat(sat, s);
+  for (double t = -ACCURACY_SPAN * 1440.0; t <= ACCURACY_SPAN * 1440.0; t += ACCURACY_STEP) {
+    if (!sgp4(wgs84, sat.satrec, t, r, v) || !sgp4f(wgs84, sat.satrec, t, rf, vf)) continue;
+    double dr[3] = {rf[0] - r[0], rf[1] - r[1], rf[2] - r[2]};
+    double dv[3] = {vf[0] - v[0], vf[1] - v[1], vf[2] - v[2]};
+    if (mag(dr) > drmax) drmax = mag(dr);
+    if (mag(dv) > dvmax) dvmax = mag(dv);
+
+    double jd = sat.satrec.jdsatepoch + t / 1440.0;
+    rv2azel(r, siteLatRad, siteLonRad, siteAltKm, jd, razel);
+    if (razel[2] < 0.0) continue;  // only where the satellite can be seen
+    rv2azel(rf, siteLatRad, siteLonRad, siteAltKm, jd, razelf);
+    double daz = fabs(floatmod(razelf[1] - razel[1] + pi, 2.0 * pi) - pi) * cos(razel[2]);
+    double del = fabs(razelf[2] - razel[2]);
+    if (daz > dazmax) dazmax = daz;
+    if (del > delmax) delmax = del;
+  }
+  printf("%-12s %12.3f %12.4f %12.6f %12.6f\n", s.name, drmax * 1000.0, dvmax * 1000.0,
+         dazmax * 180.0 / pi, delmax * 180.0 / pi);
+}
+
+// largest difference between the ephemeris of the first pass and findsat, every second of the pass
+static void ephemerisaccuracy(const benchsat& s)
+{
+  static Sgp4Ephemeris ephem;
+  Sgp4 sat;
+  passinfo overpass;
+  unsigned long start = START_UNIX;
+  unsigned long stop = START_UNIX + TRACK_FALLBACK;
+  double dazmax = 0.0, delmax = 0.0, drmax = 0.0, dlatmax = 0.0, dlonmax = 0.0, daltmax = 0.0, drrmax = 0.0;
+
+  initsat(sat, s);
+  if (sat.initpredpoint(START_UNIX, 0.0) && sat.nextpass(&overpass, 100)) {
+    start = getUnixFromJulian(overpass.jdstart);
+    stop = getUnixFromJulian(overpass.jdstop);
+  }
+  ephem.fit(sat, start, stop);
+  for (unsigned long t = start; t <= stop; t++) {
+    sat.findsat(t, topocentric | geodetic | rangerate);
+    ephem.evaluate(t);
+    double daz = fabs(floatmod(ephem.satAz - sat.satAz + 180.0, 360.0) - 180.0) * cos(sat.satEl * pi / 180.0);
+    double dlon = fabs(floatmod(ephem.satLon - sat.satLon + 180.0, 360.0) - 180.0);
+    if (daz > dazmax) dazmax = daz;
+    if (fabs(ephem.satEl - sat.satEl) > delmax) delmax = fabs(ephem.satEl - sat.satEl);
+    if (fabs(ephem.satDist - sat.satDist) > drmax) drmax = fabs(ephem.satDist - sat.satDist);
+    if (fabs(ephem.satLat - sat.satLat) > dlatmax) dlatmax = fabs(ephem.satLat - sat.satLat);
+    if (dlon > dlonmax) dlonmax = dlon;
+    if (fabs(ephem.satAlt - sat.satAlt) > daltmax) daltmax = fabs(ephem.satAlt - sat.satAlt);
+    if (fabs(ephem.satRangeRate - sat.satRangeRate) > drrmax) drrmax = fabs(ephem.satRangeRate - sat.satRangeRate);
+  }
+  printf("%-12s %12.6f %12.6f %12.3f %12.6f %12.6f %12.3f %12.3f\n", s.name, dazmax, delmax, drmax * 1000.0,
+         dlatmax, dlonmax, daltmax * 1000.0, drrmax * 1000.0);
+}
+
+// largest angle between teme2ecef per sample and teme2ecef through a sweepcontext
+static void sweepaccuracy()
+{
+  double r[3] = {6778.0, 0.0, 0.0};
+  double recef[3], recefs[3];
+  double jdstart = getJulianFromUnix(START_UNIX);
+  double worst = 0.0;
+  sweepcontext sc;
+
+  initsweep(sc, jdstart, 1.0);
+  for (long i = 0; i < SWEEP_SAMPLES; i++) {
+    teme2ecef(r, jdstart + i / 86400.0, recef);
+    teme2ecef(r, sc, recefs);
+    double d[3] = {recefs[0] - recef[0], recefs[1] - recef[1], recefs[2] - recef[2]};
+    if (mag(d) / mag(r) > worst) worst = mag(d) / mag(r);
+    advancesweep(sc);
+  }
+  printf("\nsweepcontext against teme2ecef, %d x 1 s: %.6f arcsec\n", SWEEP_SAMPLES, worst * 180.0 / pi * 3600.0);
+}
+
+int main(int argc, char* argv[])
+{
+  int repeat = 5;
+  if (argc > 1) repeat = atoi(argv[1]);
+  if (repeat < 1) repeat = 1;
+
+  printf("%s, best of %d runs\n\n", SGP4Version, repeat);
+  printf("%-12s %-10s %8s %12s %12s   %s\n", "satellite", "workload", "count", "total [ms]", "per [us]", "checksum");
+
+  for (size_t i = 0; i < sizeof(sats) / sizeof(sats[0]); i++) {
+    run(sats[i], "sgp4", benchKernel, repeat);
+    run(sats[i], "sgp4f", benchKernelf, repeat);
+    run(sats[i], "propagate", benchPropagate, repeat);
+    run(sats[i], "elevation", benchElevation, repeat);
+    run(sats[i], "passes24h", benchPasses, repeat);
+    run(sats[i], "passlist", benchPassList, repeat);
+    run(sats[i], "track1s", benchTrack, repeat);
+    run(sats[i], "batch1s", benchBatch, repeat);
+    run(sats[i], "ephem1s", benchEphemeris, repeat);
+  }
+
+  printf("\nsgp4f against sgp4, +-%.0f days from epoch (azimuth error scaled by cos(elevation))\n\n", ACCURACY_SPAN);
+  printf("%-12s %12s %12s %12s %12s\n", "satellite", "dr [m]", "dv [m/s]", "daz [deg]", "del [deg]");
+  for (size_t i = 0; i < sizeof(sats) / sizeof(sats[0]); i++) {
+    accuracy(sats[i]);
+  }
+
+  printf("\nSgp4Ephemeris against findsat over the first pass (azimuth error scaled by cos(elevation))\n\n");
+  printf("%-12s %12s %12s %12s %12s %12s %12s %12s\n", "satellite", "daz [deg]", "del [deg]", "drange [m]",
+         "dlat [deg]", "dlon [deg]", "dalt [m]", "drate [m/s]");
+  for (size_t i = 0; i < sizeof(sats) / sizeof(sats[0]); i++) {
+    ephemerisaccuracy(sats[i]);
+  }
+  sweepaccuracy();
+  return 0;
+}
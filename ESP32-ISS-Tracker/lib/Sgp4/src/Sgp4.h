@@ -2,5 +2,7 @@
 #define SGP4_H
 
 #include "sgp4pred.h"
+#include "ephemeris.h"
+#include "passpredictor.h"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,161 @@
+/*
+ephemeris.cpp
+
+Piecewise Chebyshev ephemeris, see ephemeris.h.
+The samples come from Sgp4::propagateRange, so the Sgp4 object's own position is not changed.
+*/
+
+#include "ephemeris.h"
+
+#ifdef ESP8266
+  #include <Arduino.h> //yield()
+#endif
+
+Sgp4Ephemeris::Sgp4Ephemeris(){
+  clear();
+}
+
+void Sgp4Ephemeris::clear(){
+  segments = 0;
+  jdstart = 0.0;
+  jdstop = 0.0;
+}
+
+// samples each segment at the chebyshev nodes and converts the samples to coefficients
+bool Sgp4Ephemeris::fit(Sgp4& sat, double jdfrom, double jdto){
+
+  float az, el, range, lat, lon, alt;
+  trackbuffer track = {&az, &el, &range, &lat, &lon, &alt};
+  double values[6][EPHEMERIS_ORDER];
+  double basis[EPHEMERIS_ORDER][EPHEMERIS_ORDER];
+  double span = jdto - jdfrom;
+  int s, k, j, q;
+
+  clear();
+  if (span <= 0.0) return false;
+
+  seglen = EPHEMERIS_SEGMENTSEC / 86400.0;
+  if (span / seglen > EPHEMERIS_SEGMENTS) seglen = span / EPHEMERIS_SEGMENTS;
+
+  // basis[j][k] = T_j(x_k) at the nodes x_k = cos(pi (k + 0.5) / N)
+  for (j = 0; j < EPHEMERIS_ORDER; j++){
+    for (k = 0; k < EPHEMERIS_ORDER; k++){
+      basis[j][k] = cos(pi * j * (k + 0.5) / EPHEMERIS_ORDER);
+    }
+  }
+
+  for (s = 0; s * seglen < span && s < EPHEMERIS_SEGMENTS; s++){
+    double mid = jdfrom + (s + 0.5) * seglen;
+
+    for (k = 0; k < EPHEMERIS_ORDER; k++){
+      if (sat.propagateRange(mid + 0.5 * seglen * basis[1][k], 0.0, 1, track, alloutputs) != 1) return false;
+
+      double cosel = cos(el * pi / 180.0);
+      values[0][k] = -range * cosel * cos(az * pi / 180.0);  //south
+      values[1][k] = range * cosel * sin(az * pi / 180.0);   //east
+      values[2][k] = range * sin(el * pi / 180.0);           //zenith
+      values[3][k] = lat;
+      values[4][k] = lon;
+      values[5][k] = alt;
+
+      // nodes are in time order (backwards), keep the longitude continuous over the antimeridian
+      if (k > 0){
+        while (values[4][k] - values[4][k-1] > 180.0) values[4][k] -= 360.0;
+        while (values[4][k] - values[4][k-1] < -180.0) values[4][k] += 360.0;
+      }
+    }
+
+    for (q = 0; q < 6; q++){
+      for (j = 0; j < EPHEMERIS_ORDER; j++){
+        double c = 0.0;
+        for (k = 0; k < EPHEMERIS_ORDER; k++) c += values[q][k] * basis[j][k];
+        coef[s][q][j] = 2.0 * c / EPHEMERIS_ORDER;
+      }
+    }
+    #ifdef ESP8266
+      yield();
+    #endif
+  }
+
+  segments = s;
+  jdstart = jdfrom;
+  jdstop = jdto;
+  return true;
+}
+
+bool Sgp4Ephemeris::fit(Sgp4& sat, unsigned long unixfrom, unsigned long unixto){
+  return fit(sat, getJulianFromUnix(unixfrom), getJulianFromUnix(unixto));
+}
+
+bool Sgp4Ephemeris::covers(double jd){
+  return segments > 0 && jd >= jdstart && jd <= jdstop;
+}
+
+// clenshaw recurrence for the six series of one segment, in float: the coefficients are float anyway.
+// The range rate comes from the derivative of the south, east and zenith series, whose coefficients
+// follow from the series' own by d[j-1] = d[j+1] + 2 j c[j], so it costs no extra sgp4 call.
+bool Sgp4Ephemeris::evaluate(double jd){
+
+  float value[6];
+  float rate[3];
+  int s, q, j;
+
+  if (!covers(jd)) return false;
+
+  s = (int)((jd - jdstart) / seglen);
+  if (s >= segments) s = segments - 1;
+  float x = (float)((jd - jdstart - (s + 0.5) * seglen) / (0.5 * seglen));
+
+  for (q = 0; q < 6; q++){
+    const float* c = coef[s][q];
+    float b1 = 0.0f, b2 = 0.0f, b0;
+    for (j = EPHEMERIS_ORDER - 1; j > 0; j--){
+      b0 = 2.0f * x * b1 - b2 + c[j];
+      b2 = b1;
+      b1 = b0;
+    }
+    value[q] = x * b1 - b2 + 0.5f * c[0];
+  }
+
+  for (q = 0; q < 3; q++){
+    const float* c = coef[s][q];
+    float d[EPHEMERIS_ORDER + 1];
+    d[EPHEMERIS_ORDER] = 0.0f;
+    d[EPHEMERIS_ORDER - 1] = 0.0f;
+    for (j = EPHEMERIS_ORDER - 1; j > 0; j--){
+      d[j - 1] = d[j + 1] + 2.0f * j * c[j];
+    }
+    float b1 = 0.0f, b2 = 0.0f, b0;
+    for (j = EPHEMERIS_ORDER - 2; j > 0; j--){
+      b0 = 2.0f * x * b1 - b2 + d[j];
+      b2 = b1;
+      b1 = b0;
+    }
+    rate[q] = x * b1 - b2 + 0.5f * d[0];  //per unit of x, x spans half a segment
+  }
+
+  float range = sqrtf(value[0] * value[0] + value[1] * value[1] + value[2] * value[2]);
+  float az = atan2f(value[1], -value[0]) * 180.0f / (float)pi;
+
+  satAz = az < 0.0f ? az + 360.0f : az;
+  satEl = asinf(value[2] / range) * 180.0f / (float)pi;
+  satDist = range;
+  satRangeRate = (value[0] * rate[0] + value[1] * rate[1] + value[2] * rate[2]) / range / (float)(0.5 * seglen * 86400.0);
+  satLat = value[3];
+  satLon = floatmod(value[4] + 180.0f, 360.0f) - 180.0f;
+  satAlt = value[5];
+  satJd = jd;
+  return true;
+}
+
+bool Sgp4Ephemeris::evaluate(unsigned long unix){
+  return evaluate(getJulianFromUnix(unix));
+}
+
+double Sgp4Ephemeris::getstart(){
+  return jdstart;
+}
+
+double Sgp4Ephemeris::getstop(){
+  return jdstop;
+}
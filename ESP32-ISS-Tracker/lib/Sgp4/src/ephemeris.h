@@ -0,0 +1,44 @@
+/*
+Piecewise Chebyshev ephemeris of a satellite over a short window, typically one pass.
+
+The window is cut into segments and, per segment, the topocentric vector (south, east, zenith),
+latitude, longitude and altitude are fitted with Chebyshev series from a handful of SGP4 samples.
+Afterwards a position is a few multiply-adds plus one atan2/asin, instead of a full propagation.
+Fitting the topocentric vector rather than azimuth/elevation keeps the series smooth when the
+satellite passes close to the zenith.
+*/
+
+#ifndef _ephemeris_
+#define _ephemeris_
+
+#include "sgp4pred.h"
+
+#define EPHEMERIS_ORDER 8          //chebyshev coefficients per segment and quantity
+#define EPHEMERIS_SEGMENTS 32      //maximum number of segments
+#define EPHEMERIS_SEGMENTSEC 120   //segment length in seconds, longer windows use longer segments
+
+class Sgp4Ephemeris {
+    double jdstart;   //start of the fitted window (julian date)
+    double jdstop;    //end of the fitted window (julian date)
+    double seglen;    //segment length in days
+    int segments;     //number of fitted segments, 0 when empty
+    float coef[EPHEMERIS_SEGMENTS][6][EPHEMERIS_ORDER];  //south, east, zenith [km], latitude, unwrapped longitude [degrees], altitude [km]
+
+  public:
+    double satLat, satLon, satAlt, satAz, satEl, satDist, satJd;  //last evaluated position, same units as Sgp4
+    double satRangeRate;  //range rate [km/s] from the derivative of the topocentric series
+
+    Sgp4Ephemeris();
+    bool fit(Sgp4& sat, double jdfrom, double jdto);  //fit the window [jdfrom, jdto], sat must have its site set
+    bool fit(Sgp4& sat, unsigned long unixfrom, unsigned long unixto);  //idem, from unix time
+    void clear();  //forget the fitted window
+
+    bool covers(double jd);  //true if jd lies in the fitted window
+    bool evaluate(double jd);  //set the sat* members for jd, returns false outside the window
+    bool evaluate(unsigned long unix);  //idem, from unix time
+
+    double getstart();  //start of the window (julian date)
+    double getstop();   //end of the window (julian date)
+};
+
+#endif
@@ -0,0 +1,286 @@
+/*
+passpredictor.cpp
+
+Incrementally extended pass list, see passpredictor.h.
+The near earth search uses the prediction point of the Sgp4 object; it is saved after every
+search and restored before the next one, so other users of nextpass do not disturb the list.
+The deep space scan only uses propagateRange and leaves the Sgp4 object untouched.
+*/
+
+#include "passpredictor.h"
+
+#define SIDEREALREVS 1.00273790935   //revolutions per day of a geostationary satellite
+#define GEOPARALLAX 1.18             //topocentric over geocentric angle, 42164 km / 35786 km
+#define CROSSINGTOL (1.0 / 86400.0)  //crossings and maximum to one second
+
+PassPredictor::PassPredictor(){
+  minelevation = 0.0;
+  searches = 0;
+  reset();
+}
+
+void PassPredictor::begin(double minimumElevation){
+  minelevation = minimumElevation;
+  searches = 0;
+  reset();
+}
+
+void PassPredictor::reset(){
+  listed = 0;
+  cursor = 0.0;
+  retry = 0.0;
+  epoch = 0.0;
+  satnum = 0;
+  lat = 0.0;
+  lon = 0.0;
+  alt = 0.0;
+  orbit = nearearth;
+  always = false;
+  never = false;
+}
+
+bool PassPredictor::matches(Sgp4& sat){
+  return epoch == sat.satrec.jdsatepoch && satnum == sat.satrec.satnum &&
+         lat == sat.siteLat && lon == sat.siteLon && alt == sat.siteAlt;
+}
+
+int PassPredictor::update(Sgp4& sat, double jdnow, int wanted){
+
+  int i, done;
+
+  if (wanted > PASSPREDICTOR_MAX) wanted = PASSPREDICTOR_MAX;
+
+  //new TLE or observer, the listed passes are no longer valid
+  if (!matches(sat)){
+    reset();
+    epoch = sat.satrec.jdsatepoch;
+    satnum = sat.satrec.satnum;
+    lat = sat.siteLat;
+    lon = sat.siteLon;
+    alt = sat.siteAlt;
+
+    //classify the orbit from the mean motion [rad/min] and eccentricity
+    double revs = sat.satrec.no * 1440.0 / (2.0 * pi);
+    if (sat.satrec.method != 'd') orbit = nearearth;
+    else if (fabs(revs - SIDEREALREVS) < 0.1 && sat.satrec.ecco < 0.1) orbit = geosynchronous;
+    else orbit = deepspace;
+  }
+
+  //drop the passes that are over
+  for (done = 0; done < listed && passes[done].jdstop < jdnow; done++);
+  if (done > 0){
+    for (i = done; i < listed; i++) passes[i - done] = passes[i];
+    listed -= done;
+  }
+
+  if (listed >= wanted || jdnow < retry) return listed;
+
+  if (orbit == geosynchronous && stationary(sat, jdnow)) return listed;
+  if (orbit == nearearth) search(sat, jdnow, wanted);
+  else scan(sat, jdnow, wanted);
+  return listed;
+}
+
+void PassPredictor::search(Sgp4& sat, double jdnow, int wanted){
+
+  passinfo pass;
+
+  //first search, or the clock jumped past the end of the list: start half an orbit back so a pass in progress is found
+  if (cursor == 0.0 || (listed == 0 && cursor < jdnow - 1.0 / sat.revpday)){
+    if (!sat.initpredpoint(jdnow - 0.5 / sat.revpday, minelevation)){
+      retry = jdnow + 1.0 / sat.revpday;
+      return;
+    }
+    cursor = sat.getpredpoint();
+  }
+
+  while (listed < wanted){
+    sat.setpredpoint(cursor);
+    searches++;
+    bool found = sat.nextpass(&pass, PASSPREDICTOR_ITTERATIONS);
+    cursor = sat.getpredpoint();  //the searched orbits hold no pass, also when the search failed
+    if (!found){
+      retry = jdnow + 1.0 / sat.revpday;  //try again one orbit later
+      break;
+    }
+    if (pass.jdstop >= jdnow){
+      passes[listed++] = pass;
+    }
+  }
+}
+
+// The elevation of a geosynchronous satellite only swings by about its inclination and
+// eccentricity over a day, plus the drift of its longitude. If one propagation is further than
+// that from minelevation, the answer holds for PASSPREDICTOR_GEOHOLD days.
+bool PassPredictor::stationary(Sgp4& sat, double jdnow){
+
+  float el;
+  trackbuffer track = {NULL, &el, NULL, NULL, NULL, NULL};
+  double margin;
+
+  always = false;
+  never = false;
+  if (sat.propagateRange(jdnow, 0.0, 1, track, topocentric) < 1) return false;
+
+  margin = GEOPARALLAX * (sat.satrec.inclo + 2.0 * sat.satrec.ecco) * 180.0 / pi
+         + GEOPARALLAX * fabs(sat.revpday - SIDEREALREVS) * 360.0 * PASSPREDICTOR_GEOHOLD + 0.1;
+
+  if (el - margin > minelevation) always = true;
+  else if (el + margin < minelevation) never = true;
+  else return false;
+
+  retry = jdnow + PASSPREDICTOR_GEOHOLD;
+  return true;
+}
+
+// Samples the elevation PASSPREDICTOR_SCANSTEPS times per revolution. Every run of samples above
+// minelevation is one pass, refined by bisection. A run that is still open at the end of the
+// scan is scanned again by the next update.
+void PassPredictor::scan(Sgp4& sat, double jdnow, int wanted){
+
+  float el[PASSPREDICTOR_SCANCHUNK];
+  trackbuffer track = {NULL, el, NULL, NULL, NULL, NULL};
+  double step = 1.0 / (sat.revpday * PASSPREDICTOR_SCANSTEPS);
+  double jd = cursor > jdnow ? cursor : jdnow;
+  double jdend = jd + PASSPREDICTOR_SCANDAYS;
+  double jdrise = 0.0;  //first sample of the open run, 0 when below minelevation
+  double jdpeak = 0.0;
+  float elpeak = 0.0;
+  double t;
+  int i, n;
+  passinfo pass;
+
+  while (listed < wanted && jd < jdend){
+    searches++;
+    n = sat.propagateRange(jd, step * 86400.0, PASSPREDICTOR_SCANCHUNK, track, topocentric);
+    if (n < 1) break;  //decayed
+
+    for (i = 0; i < n && listed < wanted; i++){
+      t = jd + i * step;
+      if (el[i] > minelevation){
+        if (jdrise == 0.0 || el[i] > elpeak){
+          if (jdrise == 0.0) jdrise = t;
+          jdpeak = t;
+          elpeak = el[i];
+        }
+      }
+      else if (jdrise != 0.0){
+        if (refine(sat, jdrise, jdpeak, t, step, pass) && pass.jdstop >= jdnow) passes[listed++] = pass;
+        jdrise = 0.0;
+        cursor = t;
+      }
+    }
+    if (listed >= wanted) return;
+    jd += n * step;
+  }
+
+  cursor = jdrise != 0.0 ? jdrise - step : jd;  //rescan an open run from its start
+  retry = jdnow + 1.0 / sat.revpday;
+}
+
+double PassPredictor::crossing(Sgp4& sat, double jdbelow, double jdabove, double& az){
+
+  float a, e;
+  trackbuffer track = {&a, &e, NULL, NULL, NULL, NULL};
+  double jd;
+
+  az = 0.0;
+  while (fabs(jdabove - jdbelow) > CROSSINGTOL){
+    jd = 0.5 * (jdbelow + jdabove);
+    sat.propagateRange(jd, 0.0, 1, track, topocentric);
+    if (e > minelevation) jdabove = jd;
+    else jdbelow = jd;
+  }
+  sat.propagateRange(jdabove, 0.0, 1, track, topocentric);
+  az = a;
+  return jdabove;
+}
+
+// The scan gives the first sample above minelevation (jdrise), the highest one (jdpeak) and the
+// first one below again (jdset). The visibility of deep space passes is not computed.
+// Returns false, and the pass is dropped, when no sample below minelevation is found before it
+// within PASSPREDICTOR_SCANDAYS: bisecting between two samples above it would give a wrong AOS.
+bool PassPredictor::refine(Sgp4& sat, double jdrise, double jdpeak, double jdset, double step, passinfo& pass){
+
+  float a, e, ea, eb;
+  trackbuffer track = {&a, &e, NULL, NULL, NULL, NULL};
+  double lo, hi, x1, x2;
+  const double golden = 0.381966011250105;
+  long i;
+
+  //a pass in progress at the start of the scan: step back until the elevation is below minelevation
+  lo = jdrise - step;
+  for (i = 0; ; i++){
+    if (i * step > PASSPREDICTOR_SCANDAYS) return false;
+    if (sat.propagateRange(lo, 0.0, 1, track, topocentric) < 1) return false;
+    if (e <= minelevation) break;
+    lo -= step;
+  }
+  pass.jdstart = crossing(sat, lo, lo + step, pass.azstart);
+  pass.jdstop = crossing(sat, jdset, jdset - step, pass.azstop);
+
+  //golden section search of the maximum around the highest sample
+  lo = jdpeak - step > pass.jdstart ? jdpeak - step : pass.jdstart;
+  hi = jdpeak + step < pass.jdstop ? jdpeak + step : pass.jdstop;
+  x1 = lo + golden * (hi - lo);
+  x2 = hi - golden * (hi - lo);
+  sat.propagateRange(x1, 0.0, 1, track, topocentric);
+  ea = e;
+  sat.propagateRange(x2, 0.0, 1, track, topocentric);
+  eb = e;
+  while (hi - lo > CROSSINGTOL){
+    if (ea > eb){
+      hi = x2; x2 = x1; eb = ea;
+      x1 = lo + golden * (hi - lo);
+      sat.propagateRange(x1, 0.0, 1, track, topocentric);
+      ea = e;
+    }
+    else {
+      lo = x1; x1 = x2; ea = eb;
+      x2 = hi - golden * (hi - lo);
+      sat.propagateRange(x2, 0.0, 1, track, topocentric);
+      eb = e;
+    }
+  }
+  pass.jdmax = 0.5 * (lo + hi);
+  sat.propagateRange(pass.jdmax, 0.0, 1, track, topocentric);
+  pass.maxelevation = e;
+  pass.azmax = a;
+  pass.minelevation = minelevation;
+
+  pass.jdtransit = NAN;
+  pass.aztransit = NAN;
+  pass.transitelevation = NAN;
+  pass.transit = none;
+  pass.visstart = daylight;
+  pass.visstop = daylight;
+  pass.vismax = daylight;
+  pass.vistransit = daylight;
+  pass.sight = daylight;
+  return true;
+}
+
+int PassPredictor::update(Sgp4& sat, unsigned long unixnow, int wanted){
+  return update(sat, getJulianFromUnix(unixnow), wanted);
+}
+
+int PassPredictor::count(){
+  return listed;
+}
+
+const passinfo* PassPredictor::get(int index){
+  if (index < 0 || index >= listed) return NULL;
+  return &passes[index];
+}
+
+orbitclass PassPredictor::getorbit(){
+  return orbit;
+}
+
+bool PassPredictor::alwaysvisible(){
+  return always;
+}
+
+bool PassPredictor::nevervisible(){
+  return never;
+}
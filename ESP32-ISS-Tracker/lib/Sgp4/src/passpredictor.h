@@ -0,0 +1,71 @@
+/*
+Sorted list of the upcoming passes of one satellite over one observer.
+
+The list is extended incrementally: passes that are over are dropped, and the pass search only
+runs forward from where the previous search stopped when fewer passes than wanted are left.
+Reading the next pass, or the next ten, therefore costs nothing once the list is filled.
+The list is keyed by the TLE epoch and the observer, a new TLE or site restarts the search.
+
+The search depends on the orbit. Near earth orbits use Sgp4::nextpass, which steps one
+revolution at a time. Deep space orbits are scanned coarsely and the crossings refined by
+bisection. A geosynchronous satellite that stays above (or below) the horizon is answered from
+a single propagation: no passes are listed and alwaysvisible() (or nevervisible()) is true.
+*/
+
+#ifndef _passpredictor_
+#define _passpredictor_
+
+#include "sgp4pred.h"
+
+#define PASSPREDICTOR_MAX 16          //maximum number of listed passes
+#define PASSPREDICTOR_ITTERATIONS 100 //orbits searched per nextpass call
+#define PASSPREDICTOR_SCANSTEPS 48    //coarse scan samples per revolution (deep space)
+#define PASSPREDICTOR_SCANCHUNK 32    //samples per propagateRange call of the scan
+#define PASSPREDICTOR_SCANDAYS 3.0    //days covered by one scan
+#define PASSPREDICTOR_GEOHOLD 1.0     //days an always or never visible answer is kept
+
+enum orbitclass
+{
+  nearearth,      //period below 225 minutes (SGP4)
+  deepspace,      //period of 225 minutes or more (SDP4)
+  geosynchronous  //deep space, about one revolution per sidereal day and nearly circular
+};
+
+class PassPredictor {
+    passinfo passes[PASSPREDICTOR_MAX];  //upcoming passes, sorted by start
+    int listed;       //number of passes in the list
+    double cursor;    //near earth: prediction point after the last listed pass, deep space: start of the next scan, 0 before the first search
+    double retry;     //julian date before which a failed search is not repeated
+    double epoch;     //TLE epoch the list belongs to
+    long satnum;      //satellite the list belongs to
+    double lat, lon, alt;  //observer the list belongs to
+    double minelevation;   //minimum elevation of a pass [degrees]
+    orbitclass orbit;      //orbit of the satellite, set with the key
+    bool always, never;    //geosynchronous satellite that stays above or below minelevation
+
+    bool matches(Sgp4& sat);  //true if the list belongs to the TLE and site of sat
+    bool stationary(Sgp4& sat, double jdnow);  //answer a geosynchronous satellite from one propagation, false if it may have passes
+    void search(Sgp4& sat, double jdnow, int wanted);  //near earth search with nextpass
+    void scan(Sgp4& sat, double jdnow, int wanted);    //deep space coarse scan
+    double crossing(Sgp4& sat, double jdbelow, double jdabove, double& az);  //bisection of the minelevation crossing
+    bool refine(Sgp4& sat, double jdrise, double jdpeak, double jdset, double step, passinfo& pass);  //pass from the scan samples around it, false if its rise was not found
+
+  public:
+    unsigned long searches;  //number of nextpass calls and scan chunks since begin, to profile the search load
+
+    PassPredictor();
+    void begin(double minimumElevation);  //forget all passes and set the minimum elevation [degrees]
+    void reset();  //forget all passes, the next update starts a new search
+
+    int update(Sgp4& sat, double jdnow, int wanted);  //drop finished passes and search until wanted passes are listed, returns the number of listed passes
+    int update(Sgp4& sat, unsigned long unixnow, int wanted);  //idem, from unix time
+
+    int count();  //number of listed passes
+    const passinfo* get(int index);  //pass number index, 0 is the current or next pass, NULL if not listed
+
+    orbitclass getorbit();  //orbit class of the satellite of the last update
+    bool alwaysvisible();   //geosynchronous and always above the minimum elevation
+    bool nevervisible();    //geosynchronous and never above the minimum elevation
+};
+
+#endif
@@ -29,15 +29,14 @@ recef           Position vector (ECEF)          km
 vecef           Velocity vector (ECEF)          km/s
 */
 
-//void teme2ecef(double rteme[3], double vteme[3], double jdut1, double recef[3], double vecef[3])
-void teme2ecef(double rteme[3], double jdut1, double recef[3])
+void teme2ecef(double rteme[3], double vteme[3], double jdut1, double recef[3], double vecef[3])
 {
     double gmst;
     double st[3][3];
     double rpef[3];
-    //double vpef[3];
+    double vpef[3];
     double pm[3][3];
-    //double omegaearth[3];
+    double omegaearth[3];
     
     //Get Greenwich mean sidereal time
     gmst = gstime(jdut1);
@@ -68,19 +67,121 @@ void teme2ecef(double rteme[3], double jdut1, double recef[3])
     
     //Earth's angular rotation vector (omega)
     //Note: I don't have a good source for LOD. Historically it has been on the order of 2 ms so I'm just using that as a constant. The effect is very small.
-    //omegaearth[0] = 0.0;
-    //omegaearth[1] = 0.0;
-    //omegaearth[2] = 7.29211514670698e-05 * (1.0  - 0.0015563/86400.0);
+    omegaearth[0] = 0.0;
+    omegaearth[1] = 0.0;
+    omegaearth[2] = 7.29211514670698e-05 * (1.0  - 0.0015563/86400.0);
     
     //Pseudo Earth Fixed velocity vector is st'*vteme - omegaearth X rpef
-    //vpef[0] = st[0][0] * vteme[0] + st[1][0] * vteme[1] + st[2][0] * vteme[2] - (omegaearth[1]*rpef[2] - omegaearth[2]*rpef[1]);
-    //vpef[1] = st[0][1] * vteme[0] + st[1][1] * vteme[1] + st[2][1] * vteme[2] - (omegaearth[2]*rpef[0] - omegaearth[0]*rpef[2]);
-    //vpef[2] = st[0][2] * vteme[0] + st[1][2] * vteme[1] + st[2][2] * vteme[2] - (omegaearth[0]*rpef[1] - omegaearth[1]*rpef[0]);
+    vpef[0] = st[0][0] * vteme[0] + st[1][0] * vteme[1] + st[2][0] * vteme[2] - (omegaearth[1]*rpef[2] - omegaearth[2]*rpef[1]);
+    vpef[1] = st[0][1] * vteme[0] + st[1][1] * vteme[1] + st[2][1] * vteme[2] - (omegaearth[2]*rpef[0] - omegaearth[0]*rpef[2]);
+    vpef[2] = st[0][2] * vteme[0] + st[1][2] * vteme[1] + st[2][2] * vteme[2] - (omegaearth[0]*rpef[1] - omegaearth[1]*rpef[0]);
     
     //ECEF velocty vector is the inverse of the polar motion vector multiplied by vpef
-    //vecef[0] = pm[0][0] * vpef[0] + pm[1][0] * vpef[1] + pm[2][0] * vpef[2];
-    //vecef[1] = pm[0][1] * vpef[0] + pm[1][1] * vpef[1] + pm[2][1] * vpef[2];
-    //vecef[2] = pm[0][2] * vpef[0] + pm[1][2] * vpef[1] + pm[2][2] * vpef[2];
+    vecef[0] = pm[0][0] * vpef[0] + pm[1][0] * vpef[1] + pm[2][0] * vpef[2];
+    vecef[1] = pm[0][1] * vpef[0] + pm[1][1] * vpef[1] + pm[2][1] * vpef[2];
+    vecef[2] = pm[0][2] * vpef[0] + pm[1][2] * vpef[1] + pm[2][2] * vpef[2];
+}
+
+//position only, teme2ecef without the velocity
+void teme2ecef(double rteme[3], double jdut1, double recef[3])
+{
+    double gmst;
+    double st[3][3];
+    double rpef[3];
+    double pm[3][3];
+    
+    //Get Greenwich mean sidereal time
+    gmst = gstime(jdut1);
+    
+    //st is the pef - tod matrix
+    st[0][0] = cos(gmst);
+    st[0][1] = -sin(gmst);
+    st[0][2] = 0.0;
+    st[1][0] = sin(gmst);
+    st[1][1] = cos(gmst);
+    st[1][2] = 0.0;
+    st[2][0] = 0.0;
+    st[2][1] = 0.0;
+    st[2][2] = 1.0;
+    
+    //Get pseudo earth fixed position vector by multiplying the inverse pef-tod matrix by rteme
+    rpef[0] = st[0][0] * rteme[0] + st[1][0] * rteme[1] + st[2][0] * rteme[2];
+    rpef[1] = st[0][1] * rteme[0] + st[1][1] * rteme[1] + st[2][1] * rteme[2];
+    rpef[2] = st[0][2] * rteme[0] + st[1][2] * rteme[1] + st[2][2] * rteme[2];
+    
+    //Get polar motion vector
+    polarm(jdut1, pm);
+    
+    //ECEF postion vector is the inverse of the polar motion vector multiplied by rpef
+    recef[0] = pm[0][0] * rpef[0] + pm[1][0] * rpef[1] + pm[2][0] * rpef[2];
+    recef[1] = pm[0][1] * rpef[0] + pm[1][1] * rpef[1] + pm[2][1] * rpef[2];
+    recef[2] = pm[0][2] * rpef[0] + pm[1][2] * rpef[1] + pm[2][2] * rpef[2];
+}
+
+/*
+initsweep, advancesweep
+
+A sweep context holds the earth orientation of teme2ecef for equally spaced
+samples. GMST is linear in time over a sweep, so it is advanced by a fixed
+rotation per step and recomputed with gstime every SWEEP_RESYNC steps to stop
+rounding from accumulating. Polar motion changes by about a milliarcsecond
+per day and is kept from the start of the sweep.
+
+INPUTS          DESCRIPTION                     RANGE/UNITS
+jdut1           Julian date of the first sample days
+stepsec         Time between samples            seconds
+*/
+
+#define SWEEP_RESYNC 256
+
+void initsweep(sweepcontext& sc, double jdut1, double stepsec)
+{
+    double gmst = gstime(jdut1);
+    double step = gstime(jdut1 + stepsec / 86400.0) - gmst;
+
+    sc.cosgmst = cos(gmst);
+    sc.singmst = sin(gmst);
+    sc.cosstep = cos(step);
+    sc.sinstep = sin(step);
+    polarm(jdut1, sc.pm);
+    sc.jdstart = jdut1;
+    sc.stepdays = stepsec / 86400.0;
+    sc.index = 0;
+}
+
+void advancesweep(sweepcontext& sc)
+{
+    double c, s, gmst;
+
+    sc.index++;
+    if (sc.index % SWEEP_RESYNC == 0)
+    {
+        //from the start of the sweep, summing the steps would let the julian date drift
+        gmst = gstime(sc.jdstart + sc.index * sc.stepdays);
+        sc.cosgmst = cos(gmst);
+        sc.singmst = sin(gmst);
+        return;
+    }
+    c = sc.cosgmst * sc.cosstep - sc.singmst * sc.sinstep;
+    s = sc.singmst * sc.cosstep + sc.cosgmst * sc.sinstep;
+    sc.cosgmst = c;
+    sc.singmst = s;
+}
+
+//teme2ecef for the current sample of a sweep
+void teme2ecef(double rteme[3], const sweepcontext& sc, double recef[3])
+{
+    double rpef[3];
+
+    //Pseudo earth fixed position, inverse of the pef - tod matrix times rteme
+    rpef[0] = sc.cosgmst * rteme[0] + sc.singmst * rteme[1];
+    rpef[1] = -sc.singmst * rteme[0] + sc.cosgmst * rteme[1];
+    rpef[2] = rteme[2];
+
+    //ECEF postion vector is the inverse of the polar motion vector multiplied by rpef
+    recef[0] = sc.pm[0][0] * rpef[0] + sc.pm[1][0] * rpef[1] + sc.pm[2][0] * rpef[2];
+    recef[1] = sc.pm[0][1] * rpef[0] + sc.pm[1][1] * rpef[1] + sc.pm[2][1] * rpef[2];
+    recef[2] = sc.pm[0][2] * rpef[0] + sc.pm[1][2] * rpef[1] + sc.pm[2][2] * rpef[2];
 }
 
 /*
@@ -247,6 +348,27 @@ void site(double latgd, double lon, double alt, double rs[3])
     //vs[2] = 0.0;
 }
 
+/*
+initsite
+
+Computes the site vector and the sin/cos of the ECEF to SEZ rotation once, so
+rv2azel does not redo them for every satellite or sun position.
+
+INPUTS          DESCRIPTION                     RANGE/UNITS
+latgd           Site geodetic latitude          -pi/2 to pi/2 in radians
+lon             Longitude                       -2pi to 2pi in radians
+alt             Site altitude                   km
+*/
+
+void initsite(siteinfo& obs, double latgd, double lon, double alt)
+{
+    site(latgd, lon, alt, obs.rs);
+    obs.sinlon = sin(lon);
+    obs.coslon = cos(lon);
+    obs.sincolat = sin(pi * 0.5 - latgd);
+    obs.coscolat = cos(pi * 0.5 - latgd);
+}
+
 
 /*
 rv2azel
@@ -270,55 +392,43 @@ razel           Range, azimuth, and elevation matrix
 razelrates      Range rate, azimuth rate, and elevation rate matrix
 */
 
-//void rv2azel(double ro[3], double vo[3], double latgd, double lon, double alt, double jdut1, double razel[3], double razelrates[3])
-void rv2azel(double ro[3], double latgd, double lon, double alt, double jdut1, double razel[3])
+//ECEF to range, azimuth and elevation, shared by the rv2azel versions
+//the rates are only computed when vecef and razelrates are given
+static void ecef2azel(double recef[3], const double* vecef, const siteinfo& obs, double razel[3], double razelrates[3])
 {
     //Locals
     double halfpi = pi * 0.5;
     double small  = 0.00000001;
     double temp;
-    double rs[3];
-    //double vs[3];
-    double recef[3];
-    //double vecef[3];
     double rhoecef[3];
-    //double drhoecef[3];
     double tempvec[3];
     double rhosez[3];
-    //double drhosez[3];
+    double drhosez[3];
     double magrhosez;
     double rho, az, el;
-    //double drho, daz, del;
-    
-    //Get site vector in ECEF coordinate system
-    //site(latgd, lon, alt, rs, vs);
-    site(latgd, lon, alt, rs);
+    double drho, daz, del;
     
-    //Convert TEME vectors to ECEF coordinate system
-    //teme2ecef(ro, vo, jdut1, recef, vecef);
-    teme2ecef(ro, jdut1, recef);
-    
-    //Find ECEF range vectors
+    //Find ECEF range vectors, the site does not move in ECEF
     for (int i = 0; i < 3; i++)
     {
-        rhoecef[i] = recef[i] - rs[i];
-        //drhoecef[i] = vecef[i];
+        rhoecef[i] = recef[i] - obs.rs[i];
     }
     rho = mag(rhoecef); //Range in km
     
     //Convert to SEZ (topocentric horizon coordinate system)
-    rot3(rhoecef, lon, tempvec);
-    rot2(tempvec, (halfpi-latgd), rhosez);
-    
-    //rot3(drhoecef, lon, tempvec);
-    //rot2(tempvec, (halfpi-latgd), drhosez);
+    //rot3(rhoecef, lon, tempvec) and rot2(tempvec, (halfpi-latgd), rhosez) with the site's sin/cos
+    tempvec[1] = obs.coslon*rhoecef[1] - obs.sinlon*rhoecef[0];
+    tempvec[0] = obs.coslon*rhoecef[0] + obs.sinlon*rhoecef[1];
+    tempvec[2] = rhoecef[2];
+    rhosez[2] = obs.coscolat*tempvec[2] + obs.sincolat*tempvec[0];
+    rhosez[0] = obs.coscolat*tempvec[0] - obs.sincolat*tempvec[2];
+    rhosez[1] = tempvec[1];
     
     //Calculate azimuth, and elevation
     temp = sqrt(rhosez[0]*rhosez[0] + rhosez[1]*rhosez[1]);
     if (temp < small)
     {
         el = sgn(rhosez[2]) * halfpi;
-        //az = atan2(drhosez[1], -drhosez[0]);
         az = NAN;
     }
     else
@@ -328,8 +438,25 @@ void rv2azel(double ro[3], double latgd, double lon, double alt, double jdut1, d
         az = atan2(rhosez[1], -rhosez[0]);
     }
     
+    //Move values to output vectors
+    razel[0] = rho;             //Range (km)
+    razel[1] = az;              //Azimuth (radians)
+    razel[2] = el;              //Elevation (radians)
+    
+    if (vecef == NULL || razelrates == NULL)
+    {
+        return;
+    }
+    
+    //Same rotation for the range rate vector
+    tempvec[1] = obs.coslon*vecef[1] - obs.sinlon*vecef[0];
+    tempvec[0] = obs.coslon*vecef[0] + obs.sinlon*vecef[1];
+    tempvec[2] = vecef[2];
+    drhosez[2] = obs.coscolat*tempvec[2] + obs.sincolat*tempvec[0];
+    drhosez[0] = obs.coscolat*tempvec[0] - obs.sincolat*tempvec[2];
+    drhosez[1] = tempvec[1];
+    
     //Calculate rates for range, azimuth, and elevation
-    /**
     drho = dot(rhosez,drhosez) / rho;
     
     if(fabs(temp*temp) > small)
@@ -349,15 +476,48 @@ void rv2azel(double ro[3], double latgd, double lon, double alt, double jdut1, d
     {
         del = 0.0;
     }
-    ***/
-    //Move values to output vectors
-    razel[0] = rho;             //Range (km)
-    razel[1] = az;              //Azimuth (radians)
-    razel[2] = el;              //Elevation (radians)
     
-    //razelrates[0] = drho;       //Range rate (km/s)
-    //razelrates[1] = daz;        //Azimuth rate (rad/s)
-    //razelrates[2] = del;        //Elevation rate (rad/s)
+    razelrates[0] = drho;       //Range rate (km/s)
+    razelrates[1] = daz;        //Azimuth rate (rad/s)
+    razelrates[2] = del;        //Elevation rate (rad/s)
+}
+
+//void rv2azel(double ro[3], double vo[3], double latgd, double lon, double alt, double jdut1, double razel[3], double razelrates[3])
+void rv2azel(double ro[3], double latgd, double lon, double alt, double jdut1, double razel[3])
+{
+    siteinfo obs;
+
+    initsite(obs, latgd, lon, alt);
+    rv2azel(ro, obs, jdut1, razel);
+}
+
+//rv2azel for a site prepared by initsite
+void rv2azel(double ro[3], const siteinfo& obs, double jdut1, double razel[3])
+{
+    double recef[3];
+
+    //Convert TEME vectors to ECEF coordinate system
+    teme2ecef(ro, jdut1, recef);
+    ecef2azel(recef, NULL, obs, razel, NULL);
+}
+
+//rv2azel with the range, azimuth and elevation rates, for a site prepared by initsite
+void rv2azel(double ro[3], double vo[3], const siteinfo& obs, double jdut1, double razel[3], double razelrates[3])
+{
+    double recef[3];
+    double vecef[3];
+
+    teme2ecef(ro, vo, jdut1, recef, vecef);
+    ecef2azel(recef, vecef, obs, razel, razelrates);
+}
+
+//rv2azel for the current sample of a sweep
+void rv2azel(double ro[3], const siteinfo& obs, const sweepcontext& sc, double razel[3])
+{
+    double recef[3];
+
+    teme2ecef(ro, sc, recef);
+    ecef2azel(recef, NULL, obs, razel, NULL);
 }
 
 void rot3(double invec[3], double xval, double outvec[3])
@@ -14,9 +14,26 @@ Ported to C++ by Grady Hillhouse with some modifications, July 2015.
 #include <math.h>
 #include <string.h>
 
-//void teme2ecef(double rteme[3], double vteme[3], double jdut1, double recef[3], double vecef[3]);
+//Earth orientation for a sweep of equally spaced samples. initsweep computes GMST and the polar motion
+//matrix once, advancesweep rotates GMST by one step without calling gstime again.
+struct sweepcontext
+{
+    double cosgmst, singmst;  //current GMST
+    double cosstep, sinstep;  //GMST increment per step
+    double pm[3][3];          //polar motion, constant over a sweep
+    double jdstart, stepdays; //first sample and step, for resynchronisation
+    long index;               //current sample
+};
+
+void initsweep(sweepcontext& sc, double jdut1, double stepsec);
+
+void advancesweep(sweepcontext& sc);
+
+void teme2ecef(double rteme[3], double vteme[3], double jdut1, double recef[3], double vecef[3]);
 void teme2ecef(double rteme[3], double jdut1, double recef[3]);
 
+void teme2ecef(double rteme[3], const sweepcontext& sc, double recef[3]);
+
 void polarm(double jdut1, double pm[3][3]);
 
 void ijk2ll(double r[3], double latlongh[3]);
@@ -24,9 +41,25 @@ void ijk2ll(double r[3], double latlongh[3]);
 //void site(double latgd, double lon, double alt, double rs[3], double vs[3]);
 void site(double latgd, double lon, double alt, double rs[3]);
 
+//Observer position and ECEF to SEZ rotation, filled once by initsite
+struct siteinfo
+{
+    double rs[3];                //site position vector (ECEF) in km
+    double sinlon, coslon;       //rot3 by the longitude
+    double sincolat, coscolat;   //rot2 by 90 degrees minus the latitude
+};
+
+void initsite(siteinfo& obs, double latgd, double lon, double alt);
+
 //void rv2azel(double ro[3], double vo[3], double latgd, double lon, double alt, double jdut1, double razel[3], double razelrates[3]);
 void rv2azel(double ro[3], double latgd, double lon, double alt, double jdut1, double razel[3]);
 
+void rv2azel(double ro[3], const siteinfo& obs, double jdut1, double razel[3]);
+
+void rv2azel(double ro[3], double vo[3], const siteinfo& obs, double jdut1, double razel[3], double razelrates[3]);
+
+void rv2azel(double ro[3], const siteinfo& obs, const sweepcontext& sc, double razel[3]);
+
 void rot3(double invec[3], double xval, double outvec[3]);
 
 void rot2(double invec[3], double xval, double outvec[3]);
@@ -5,7 +5,10 @@ Most functions are based on the columns written by Dr. T.S. Kelso on the celestr
 Written by Hopperpop
 */
 
-#include <Arduino.h>
+#include <stdio.h>
+#ifdef ESP8266
+#include <Arduino.h>  //yield()
+#endif
 #include "sgp4ext.h"
 #include "sgp4unit.h"
 #include "sgp4io.h"
@@ -26,6 +29,7 @@ Sgp4::Sgp4(){
    whichconst = wgs84;   //newest constants
    sunoffset = -0.10471975511966; //sun aboven -6°  => not dark enough
    offset = 0.0;
+   line1[0] = '\0';  //no tle loaded yet, init() compares against it
 }
 
 ///Init functions/////
@@ -35,9 +39,9 @@ bool Sgp4::init(const char naam[24], char longstr1[130], char longstr2[130]){
 	  return false;
   }
 
-  strlcpy(satName, naam, sizeof(satName));
-  strlcpy(line1, longstr1, sizeof(line1));
-  strlcpy(line2, longstr2, sizeof(line2));
+  snprintf(satName, sizeof(satName), "%s", naam);
+  snprintf(line1, sizeof(line1), "%s", longstr1);
+  snprintf(line2, sizeof(line2), "%s", longstr2);
 
   twoline2rv(longstr1, longstr2, opsmode, whichconst, satrec );
 
@@ -53,6 +57,7 @@ void Sgp4::site(double lat, double lon, double alt){
   siteAlt = alt / 1000; //meters to kilometers
   siteLatRad = siteLat * pi / 180.0;
   siteLonRad = siteLon * pi / 180.0;
+  initsite(observer, siteLatRad, siteLonRad, siteAlt);  //rv2azel reuses the site vector and rotation
 }
 
 ///set sunoffset
@@ -62,37 +67,103 @@ void Sgp4::setsunrise(double degrees){
 
 ////Location functions/////
 void Sgp4::findsat(double jdI){
+  findsat(jdI, alloutputs);
+}
+
+void Sgp4::findsat(unsigned long unix){
+  findsat(getJulianFromUnix(unix));
+}
+
+// the sun series and the iterative latitude solve dominate the cost, so they are only run when asked for
+void Sgp4::findsat(double jdI, uint8_t outputs){
 
   double latlongh[3];
   double recef[3];
-  double vecef[3];
   double razelrates[3];
 
   jdC = jdI;
 
   double tsince = (jdC - satrec.jdsatepoch) * 24.0 * 60.0;
-  sgp4(whichconst, satrec, tsince, ro, vo);
-  rv2azel(ro, siteLatRad, siteLonRad, siteAlt, jdC, razel);
-  teme2ecef(ro, jdC, recef);
-  ijk2ll(recef, latlongh);
-
-  satLat = latlongh[0]*180/pi;  //Latidude sattelite (degrees)
-  satLon = latlongh[1]*180/pi;  //longitude sattelite (degrees)
-  satAlt = latlongh[2];   //Altitude sattelite (degrees)
-  satAz = floatmod( razel[1]*180/pi+360.0, 360.0);  //Azemith sattelite (degrees)
-  satEl = razel[2]*180/pi; //elevation sattelite (degrees)
-  satDist = razel[0];  //Distance to sattelite (km)
+  sgp4f(whichconst, satrec, tsince, ro, vo);  //display path, the float kernel is accurate enough
   satJd = jdI;  //time (julian day)
 
-  satVis = visible();
-  if (satEl < 0.0) {
+  if (outputs & rangerate){
+    rv2azel(ro, vo, observer, jdC, razel, razelrates);  //same razel, plus the velocity from sgp4
+    satRangeRate = razelrates[0];
+  }
+  else if (outputs & topocentric){
+    rv2azel(ro, observer, jdC, razel);
+  }
+  if (outputs & topocentric){
+    satAz = floatmod( razel[1]*180/pi+360.0, 360.0);  //Azemith sattelite (degrees)
+    satEl = razel[2]*180/pi; //elevation sattelite (degrees)
+    satDist = razel[0];  //Distance to sattelite (km)
+  }
+
+  if (outputs & geodetic){
+    teme2ecef(ro, jdC, recef);
+    ijk2ll(recef, latlongh);
+    satLat = latlongh[0]*180/pi;  //Latidude sattelite (degrees)
+    satLon = latlongh[1]*180/pi;  //longitude sattelite (degrees)
+    satAlt = latlongh[2];   //Altitude sattelite (degrees)
+  }
+
+  if (outputs & sunlight){
+    satVis = visible();
+    if ((outputs & topocentric) && satEl < 0.0) {
       satVis = -2; //under horizon
+    }
   }
 
 }
 
-void Sgp4::findsat(unsigned long unix){
-  findsat(getJulianFromUnix(unix));
+void Sgp4::findsat(unsigned long unix, uint8_t outputs){
+  findsat(getJulianFromUnix(unix), outputs);
+}
+
+// propagates count samples spaced stepsec seconds apart into the caller's arrays
+// only the requested outputs are computed, the sat* members are left untouched
+int Sgp4::propagateRange(double jdstart, double stepsec, int count, trackbuffer& track, uint8_t outputs){
+
+  double r[3];
+  double v[3];
+  double razell[3];
+  double recef[3];
+  double latlongh[3];
+  double tsince;
+  double jd;
+  int i;
+  sweepcontext sc;  //earth rotation is advanced per sample instead of recomputed
+
+  initsweep(sc, jdstart, stepsec);
+  for (i = 0; i < count; i++){
+    jd = jdstart + i * stepsec / 86400.0;
+    tsince = (jd - satrec.jdsatepoch) * 24.0 * 60.0;
+    if (!sgp4f(whichconst, satrec, tsince, r, v)) break;
+
+    if (outputs & topocentric){
+      rv2azel(r, observer, sc, razell);
+      if (track.az) track.az[i] = floatmod(razell[1]*180/pi + 360.0, 360.0);
+      if (track.el) track.el[i] = razell[2]*180/pi;
+      if (track.range) track.range[i] = razell[0];
+    }
+    if (outputs & geodetic){
+      teme2ecef(r, sc, recef);
+      ijk2ll(recef, latlongh);
+      if (track.lat) track.lat[i] = latlongh[0]*180/pi;
+      if (track.lon) track.lon[i] = latlongh[1]*180/pi;
+      if (track.alt) track.alt[i] = latlongh[2];
+    }
+    advancesweep(sc);
+    #ifdef ESP8266
+      if ((i & 63) == 63) yield();
+    #endif
+  }
+  return i;
+}
+
+int Sgp4::propagateRange(unsigned long unixstart, double stepsec, int count, trackbuffer& track, uint8_t outputs){
+  return propagateRange(getJulianFromUnix(unixstart), stepsec, count, track, outputs);
 }
 
 
@@ -103,8 +174,8 @@ double Sgp4::sgp4wrap( double jdCe){
 
     double tsince = (jdCe - satrec.jdsatepoch) * 24.0 * 60.0;
 
-    sgp4(whichconst, satrec, tsince, ro, vo);
-    rv2azel(ro, siteLatRad, siteLonRad, siteAlt, jdCe, razel);
+    sgp4(whichconst, satrec, tsince, ro, vo);  //double kernel, the root finding needs the full precision
+    rv2azel(ro, observer, jdCe, razel);
     return -razel[2]+offset;
 
 }
@@ -28,6 +28,28 @@ enum shadowtransit
 	leave
 };
 
+//outputs computed by findsat and propagateRange, can be or'ed together
+enum sgp4output
+{
+  topocentric = 1,  //azimuth, elevation and range seen from the site
+  geodetic = 2,     //latitude, longitude and altitude of the subsatellite point
+  sunlight = 4,     //sun azimuth/elevation and satVis (findsat only)
+  rangerate = 8,    //range rate seen from the site, for doppler (findsat only)
+  alloutputs = 15
+};
+
+//struct-of-arrays track buffer filled by propagateRange, the arrays are owned by the caller.
+//Arrays for outputs that are not requested may be NULL.
+struct trackbuffer
+{
+  float* az;     //azimuth [degrees]
+  float* el;     //elevation [degrees]
+  float* range;  //distance to satellite [km]
+  float* lat;    //latitude [degrees]
+  float* lon;    //longitude [degrees]
+  float* alt;    //altitude [km]
+};
+
 struct passinfo
 {
   double jdstart;
@@ -66,6 +88,7 @@ class Sgp4 {
     double sunoffset;  //Min elevation sun for daylight in radials
     double jdC;    //Current used julian date
     double jdCp;    //Current used julian date for prediction
+    siteinfo observer;  //site vector and rotation, set by site()
 
     double sgp4wrap( double jdCe);  //returns the elevation for a given julian date
 	double visiblewrap(double jdCe);  //returns angle between sun surface and earth surface
@@ -79,6 +102,7 @@ class Sgp4 {
     elsetrec satrec;
     double siteLat, siteLon, siteAlt, siteLatRad, siteLonRad;
     double satLat, satLon, satAlt, satAz, satEl, satDist,satJd;
+    double satRangeRate;  //range rate [km/s], positive when the satellite moves away
     double sunAz, sunEl;
 	int16_t satVis;
 
@@ -89,6 +113,11 @@ class Sgp4 {
 
     void findsat(double jdI);     //find satellite position from julian date
     void findsat(unsigned long);  //find satellite position from unix time
+    void findsat(double jdI, uint8_t outputs);  //only compute the sgp4output flags in outputs, the other members keep their previous value
+    void findsat(unsigned long unix, uint8_t outputs);  //idem, from unix time
+
+    int propagateRange(double jdstart, double stepsec, int count, trackbuffer& track, uint8_t outputs);  //fill track with count samples every stepsec seconds, returns the number of samples written
+    int propagateRange(unsigned long unixstart, double stepsec, int count, trackbuffer& track, uint8_t outputs);  //idem, starting from unix time
 
     bool nextpass( passinfo* passdata, int itterations); // calculate next overpass data, returns true if succesfull
 	bool nextpass(passinfo* passdata, int itterations, bool direc); //direc = false for forward search, true for backwards search
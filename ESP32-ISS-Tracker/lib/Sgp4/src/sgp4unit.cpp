@@ -1987,6 +1987,234 @@ bool sgp4
 }  // end sgp4
 
 
+/*-----------------------------------------------------------------------------
+*
+*                             procedure sgp4f
+*
+*  this procedure is the near earth branch of sgp4 evaluated in single
+*    precision, for hardware with a float fpu and software doubles (esp32).
+*    the secular update (the large, linear in time angles) stays in double and
+*    is reduced to 0..2pi before it is handed to the float part, so the float
+*    rounding does not grow with the time since epoch. deep space orbits
+*    (method 'd'), times further than SGP4_FLOAT_SPAN (3 days) from epoch
+*    and builds with SGP4_FLOAT_KERNEL 0 use sgp4 unchanged.
+*
+*  error budget against sgp4, wgs84, +-3 days from epoch (SGP4_FLOAT_SPAN,
+*    the range sgp4f is used for), 1 minute steps
+*    (extras/bench/sgp4_bench, leo, polar leo and elliptical leo test sets) :
+*    position    - < 12 m
+*    velocity    - < 0.012 m/s
+*    az, el      - < 0.0005 deg while the satellite is above the horizon
+*    this is far below the error of the tle itself (~1 km at epoch) and
+*    below one pixel on the display, but the pass root finding keeps using
+*    sgp4 so aos/los times do not move.
+*
+*  inputs, outputs and error codes are the same as sgp4.
+*
+*  coupling      :
+*    getgravconst-
+*    sgp4        - deep space orbits
+*
+*  references    :
+*    see sgp4
+  ----------------------------------------------------------------------------*/
+
+bool sgp4f
+     (
+       gravconsttype whichconst, elsetrec& satrec,  double tsince,
+       double r[3],  double v[3]
+     )
+{
+#if SGP4_FLOAT_KERNEL
+     const double twopi = 2.0 * pi;
+     double argpm, argpdf, nodem, nodedf, mm, xmdf, xlm, t2, t3, t4,
+            tempa, tempe, templ, delomg, delm, delmtemp, temp,
+            tumin, mu, radiusearthkm, xke, j2, j3, j4, j3oj2;
+     float  am   , axnl  , aynl , betal , cnod  , cos2u, coseo1, cosi , cosip,
+            cossu, cosu  , em   , ecose , el2   , eo1  , esine , pl   , mrt  ,
+            mvt  , nm    , rdotl, rl    , rvdot , rvdotl, sin2u, sineo1, sini ,
+            sinip, sinsu , sinu , snod  , su    , tem5 , tempf , temp1, temp2,
+            u    , ux    , uy   , uz    , vx    , vy   , vz    , xinc , xincp,
+            xl   , xmx   , xmy  , xnode , nodep , argpp, xkef  , vkmpersec;
+     int ktr;
+
+     if (satrec.method == 'd' || fabs(tsince) > SGP4_FLOAT_SPAN)
+         return sgp4(whichconst, satrec, tsince, r, v);
+
+     getgravconst( whichconst, tumin, mu, radiusearthkm, xke, j2, j3, j4, j3oj2 );
+     xkef      = (float)xke;
+     vkmpersec = (float)(radiusearthkm * xke/60.0);
+
+     /* --------------------- clear sgp4 error flag ----------------- */
+     satrec.t     = tsince;
+     satrec.error = 0;
+
+     /* ------- update for secular gravity and atmospheric drag ----- */
+     /* ------ in double, these angles grow with the time since epoch */
+     xmdf    = satrec.mo + satrec.mdot * satrec.t;
+     argpdf  = satrec.argpo + satrec.argpdot * satrec.t;
+     nodedf  = satrec.nodeo + satrec.nodedot * satrec.t;
+     argpm   = argpdf;
+     mm      = xmdf;
+     t2      = satrec.t * satrec.t;
+     nodem   = nodedf + satrec.nodecf * t2;
+     tempa   = 1.0 - satrec.cc1 * satrec.t;
+     tempe   = satrec.bstar * satrec.cc4 * satrec.t;
+     templ   = satrec.t2cof * t2;
+
+     if (satrec.isimp != 1)
+       {
+         delomg = satrec.omgcof * satrec.t;
+         delmtemp =  1.0 + satrec.eta * cosf((float)floatmod(xmdf, twopi));
+         delm   = satrec.xmcof *
+                  (delmtemp * delmtemp * delmtemp -
+                  satrec.delmo);
+         temp   = delomg + delm;
+         mm     = xmdf + temp;
+         argpm  = argpdf - temp;
+         t3     = t2 * satrec.t;
+         t4     = t3 * satrec.t;
+         tempa  = tempa - satrec.d2 * t2 - satrec.d3 * t3 -
+                          satrec.d4 * t4;
+         tempe  = tempe + satrec.bstar * satrec.cc5 * (sinf((float)floatmod(mm, twopi)) -
+                          satrec.sinmao);
+         templ  = templ + satrec.t3cof * t3 + t4 * (satrec.t4cof +
+                          satrec.t * satrec.t5cof);
+       }
+
+     nm    = (float)satrec.no;
+     em    = (float)satrec.ecco;
+     if (nm <= 0.0f)
+       {
+         satrec.error = 2;
+         return false;
+       }
+     am = powf(xkef / nm, 2.0f / 3.0f) * (float)(tempa * tempa);
+     nm = xkef / (am * sqrtf(am));
+     em = em - (float)tempe;
+
+     if ((em >= 1.0f) || (em < -0.001f))
+       {
+         satrec.error = 1;
+         return false;
+       }
+     if (em < 1.0e-6f)
+         em  = 1.0e-6f;
+     mm     = mm + satrec.no * templ;
+     xlm    = mm + argpm + nodem;
+
+     nodem  = floatmod(nodem, twopi);
+     argpm  = floatmod(argpm, twopi);
+     xlm    = floatmod(xlm, twopi);
+     mm     = floatmod(xlm - argpm - nodem, twopi);
+
+     /* ------- from here on the angles are in 0..2pi, use floats ---- */
+     xincp  = (float)satrec.inclo;
+     argpp  = (float)argpm;
+     nodep  = (float)nodem;
+     sinip  = sinf(xincp);
+     cosip  = cosf(xincp);
+
+     /* -------------------- long period periodics ------------------ */
+     axnl = em * cosf(argpp);
+     tempf = 1.0f / (am * (1.0f - em * em));
+     aynl = em * sinf(argpp) + tempf * (float)satrec.aycof;
+     xl   = tempf * (float)satrec.xlcof * axnl;
+
+     /* --------------------- solve kepler's equation --------------- */
+     /* ----- float resolution is ~1e-7 rad, stop well above that --- */
+     /* -- u = xl - nodep, summed in double to keep the float small -- */
+     u    = (float)floatmod(mm + argpm + (double)xl, twopi);
+     eo1  = u;
+     tem5 = 9999.9f;
+     ktr = 1;
+     sineo1 = 0.0f;
+     coseo1 = 1.0f;
+     while (( fabsf(tem5) >= 1.0e-6f) && (ktr <= 10) )
+       {
+         sineo1 = sinf(eo1);
+         coseo1 = cosf(eo1);
+         tem5   = 1.0f - coseo1 * axnl - sineo1 * aynl;
+         tem5   = (u - aynl * coseo1 + axnl * sineo1 - eo1) / tem5;
+         if(fabsf(tem5) >= 0.95f)
+             tem5 = tem5 > 0.0f ? 0.95f : -0.95f;
+         eo1    = eo1 + tem5;
+         ktr = ktr + 1;
+       }
+
+     /* ------------- short period preliminary quantities ----------- */
+     ecose = axnl*coseo1 + aynl*sineo1;
+     esine = axnl*sineo1 - aynl*coseo1;
+     el2   = axnl*axnl + aynl*aynl;
+     pl    = am*(1.0f-el2);
+     if (pl < 0.0f)
+       {
+         satrec.error = 4;
+         return false;
+       }
+
+     rl     = am * (1.0f - ecose);
+     rdotl  = sqrtf(am) * esine/rl;
+     rvdotl = sqrtf(pl) / rl;
+     betal  = sqrtf(1.0f - el2);
+     tempf  = esine / (1.0f + betal);
+     sinu   = am / rl * (sineo1 - aynl - axnl * tempf);
+     cosu   = am / rl * (coseo1 - axnl + aynl * tempf);
+     su     = atan2f(sinu, cosu);
+     sin2u  = (cosu + cosu) * sinu;
+     cos2u  = 1.0f - 2.0f * sinu * sinu;
+     tempf  = 1.0f / pl;
+     temp1  = 0.5f * (float)j2 * tempf;
+     temp2  = temp1 * tempf;
+
+     /* -------------- update for short period periodics ------------ */
+     mrt   = rl * (1.0f - 1.5f * temp2 * betal * (float)satrec.con41) +
+             0.5f * temp1 * (float)satrec.x1mth2 * cos2u;
+     su    = su - 0.25f * temp2 * (float)satrec.x7thm1 * sin2u;
+     xnode = nodep + 1.5f * temp2 * cosip * sin2u;
+     xinc  = xincp + 1.5f * temp2 * cosip * sinip * cos2u;
+     mvt   = rdotl - nm * temp1 * (float)satrec.x1mth2 * sin2u / xkef;
+     rvdot = rvdotl + nm * temp1 * ((float)satrec.x1mth2 * cos2u +
+             1.5f * (float)satrec.con41) / xkef;
+
+     /* --------------------- orientation vectors ------------------- */
+     sinsu =  sinf(su);
+     cossu =  cosf(su);
+     snod  =  sinf(xnode);
+     cnod  =  cosf(xnode);
+     sini  =  sinf(xinc);
+     cosi  =  cosf(xinc);
+     xmx   = -snod * cosi;
+     xmy   =  cnod * cosi;
+     ux    =  xmx * sinsu + cnod * cossu;
+     uy    =  xmy * sinsu + snod * cossu;
+     uz    =  sini * sinsu;
+     vx    =  xmx * cossu - cnod * sinsu;
+     vy    =  xmy * cossu - snod * sinsu;
+     vz    =  sini * cossu;
+
+     /* --------- position and velocity (in km and km/sec) ---------- */
+     r[0] = (mrt * ux)* radiusearthkm;
+     r[1] = (mrt * uy)* radiusearthkm;
+     r[2] = (mrt * uz)* radiusearthkm;
+     v[0] = (mvt * ux + rvdot * vx) * vkmpersec;
+     v[1] = (mvt * uy + rvdot * vy) * vkmpersec;
+     v[2] = (mvt * uz + rvdot * vz) * vkmpersec;
+
+     // sgp4fix for decaying satellites
+     if (mrt < 1.0f)
+       {
+         satrec.error = 6;
+         return false;
+       }
+
+     return true;
+#else
+     return sgp4(whichconst, satrec, tsince, r, v);
+#endif
+}  // end sgp4f
+
+
 /* -----------------------------------------------------------------------------
 *
 *                           function gstime
@@ -55,6 +55,14 @@
 
 #define pi 3.14159265358979323846
 
+// sgp4f evaluates near earth orbits in single precision (see sgp4unit.cpp for the error budget).
+// Build with -D SGP4_FLOAT_KERNEL=0 to make it run the double precision sgp4 instead.
+#ifndef SGP4_FLOAT_KERNEL
+#define SGP4_FLOAT_KERNEL 1
+#endif
+// sgp4f falls back to sgp4 further than this from epoch (minutes), where its error budget was not measured
+#define SGP4_FLOAT_SPAN 4320.0
+
 // -------------------------- structure declarations ----------------------------
 typedef enum
 {
@@ -109,6 +117,12 @@ bool sgp4
        double r[3],  double v[3]
      );
 
+bool sgp4f
+     (
+       gravconsttype whichconst, elsetrec& satrec,  double tsince,
+       double r[3],  double v[3]
+     );
+
 double  gstime
         (
           double jdut1
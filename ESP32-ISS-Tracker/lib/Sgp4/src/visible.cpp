@@ -102,7 +102,7 @@ double Sgp4::visiblewrap(double jdCe) {
 	double razell[3];
 
 	sun(jdC, rsun);  //calculate sun poistion vector
-	rv2azel(rsun, siteLatRad, siteLonRad, siteAlt, jdC, razell);  //calc sun satEl
+	rv2azel(rsun, observer, jdC, razell);  //calc sun satEl
 
 	double rsunsat[3]; //vector between sat and sun
 	double rearth[3];
@@ -141,7 +141,7 @@ int16_t Sgp4::visible(bool& notdark, double& deltaphi){
     double razell[3];
 
     sun(jdC, rsun);  //calculate sun poistion vector
-    rv2azel(rsun, siteLatRad, siteLonRad, siteAlt, jdC, razell);  //calc sun satEl
+    rv2azel(rsun, observer, jdC, razell);  //calc sun satEl
 
     sunEl = razell[2] * 180 / pi;
       sunAz = razell[1] * 180 / pi;
@@ -74,6 +74,44 @@ const double OBSERVER_ALTITUDE = 500.0;
 // Touch screen detectipn treshold (increase if pages are scrolling without pressing the TFT)
 //const int touchTreshold =900;
 
+// Rotator control (Hamlib rotctld protocol), e.g. rotctl -m 2 -r <tracker IP>:4533 p
+const uint16_t ROTCTLD_PORT = 4533;
+// Push mode: the tracker sends "P az el" to the rotctld driving the rotator, "" to disable (an IP avoids DNS lookups)
+const char* ROTATOR_PUSH_HOST = "";
+const uint16_t ROTATOR_PUSH_PORT = 4533;
+const int ROTATOR_LEAD_MS = 1000; // Targets are sent this far ahead, to make up for the rotator slew
+
+// Doppler correction, sent during the passes to a rigctld (Hamlib) as "F <downlink Hz>" and "I <uplink Hz>"
+// (split, enabled with "S 1 VFOB" when connecting)
+const char* RIGCTLD_HOST = ""; // "" to disable
+const uint16_t RIGCTLD_PORT = 4532;
+const double DOPPLER_RATE = 2; // Frequency updates per second, 0.2 to 10
+
+// Transponders, nominal frequencies (middle of the passband for the linear ones), 0 when there is none
+struct Transponder
+{
+    int catalogueNumber;
+    const char* name;
+    double uplinkMHz;
+    double downlinkMHz;
+};
+const Transponder TRANSPONDERS[] = {
+    {25544, "ISS FM repeater", 145.990, 437.800},
+    {27607, "SO-50 FM", 145.850, 436.795},
+    {43017, "AO-91 FM", 435.250, 145.960},
+    {43137, "AO-92 FM", 435.350, 145.880},
+    {41168, "AO-85 FM", 435.170, 145.980},
+    {40908, "LilacSat-2 FM", 144.350, 437.200},
+    {24278, "FO-29 linear (inverting)", 145.950, 435.850},
+    {7530, "AO-7 mode B linear (inverting)", 432.150, 145.950},
+    {39444, "AO-73 linear (inverting)", 435.140, 145.960},
+    {43770, "CAS-4A linear (inverting)", 435.220, 145.860},
+    {43771, "CAS-4B linear (inverting)", 435.280, 145.915},
+    {25338, "NOAA 15 APT", 0, 137.620},
+    {28654, "NOAA 18 APT", 0, 137.9125},
+    {33591, "NOAA 19 APT", 0, 137.100},
+};
+
 // Buzzer notifications; set seconds before next pass, or 0 for none
 const int beepsNotificationBeforeAOSandLOS=15;
 bool notificationAtTCA=true;
@@ -10,9 +10,25 @@
 #include <PNGdec.h> // Include the PNG decoder library
 // https://notisrac.github.io/FileToCArray/
 #include "ISSsplashImage.h" // Image is stored here in an 8-bit array
-#include "worldMap.h"       // Image is stored here in an 8-bit array
+// Images converted by tools/assets.py (PlatformIO pre script) are drawn by drawRleImage(), the others by PNGdec
+#if __has_include("assets/worldMapRle.h")
+#include "assets/worldMapRle.h"
+#define WORLD_MAP_RLE
+#else
+#include "worldMap.h" // Image is stored here in an 8-bit array
+#endif
+#if __has_include("assets/fancySplashRle.h")
+#include "assets/fancySplashRle.h"
+#define FANCY_SPLASH_RLE
+#else
 #include "fancySplashImage.h"
+#endif
+#if __has_include("assets/expedition72Rle.h")
+#include "assets/expedition72Rle.h"
+#define EXPEDITION72_RLE
+#else
 #include "expedition72.h"
+#endif
 #include <HB9IIU7segFonts.h> //  https://rop.nl/truetype2gfx/   https://fontforge.org/en-US/
 #include <WebSocketsServer.h>
 
@@ -20,6 +36,13 @@
 TFT_eSPI tft = TFT_eSPI();
 // PNG decoder instance
 PNG png;
+// PNG rows are batched so that one pushImage() sends several rows instead of one
+const int PNG_BATCH_WIDTH = 480;  // Widest image (full screen)
+const int PNG_BATCH_ROWS = 8;     // Rows per batch, 480 x 8 pixels = 7.5 KB
+uint16_t *pngBatch = NULL;
+int pngBatchRows = 0;             // Rows in the batch
+int pngBatchY = 0;                // Screen row of its first row
+int pngBatchWidth = 0;            // Width of its rows
 // SGP4 decoder instance
 Sgp4 sat;
 // WebSocket server on port 4235
@@ -59,6 +82,241 @@ float culminationAzimuth = 0.0; // Variable to store azimuth at culmination
 unsigned long passDuration = 0; // Duration of the pass in seconds
 unsigned long passMinutes = 0;  // Pass duration in minutes
 unsigned long passSeconds = 0;  // Remaining seconds after minutes
+// Ephemeris of the next (or current) pass, shared by the plot pages and the main page during the pass
+const int PASS_TRACK_MARGIN = 30;    // Seconds added before AOS and after LOS
+Sgp4Ephemeris passEphemeris;         // Chebyshev fit over the pass window
+unsigned long passTrackStart = 0;    // Unix time of the first second covered
+unsigned long passTrackEnd = 0;      // Unix time of the last second covered
+unsigned long passTrackForPass = 0;  // nextPassStart the ephemeris was fitted for
+// Adaptive track sampling: sample times are chosen from the projected pixel distance between neighbouring samples
+const float TRACK_TOLERANCE_PIXELS = 0.5; // Largest deviation of the drawn polyline from the projected track
+const unsigned long TRACK_MIN_STEP = 1;   // Seconds, finest spacing of two samples
+const int TRACK_SEED_SEGMENTS = 8;        // Uniform segments refined from, so that no bend is stepped over
+const int TRACK_SAMPLES_MAX = 256;        // Samples kept for one plot
+struct TrackSample
+{
+    unsigned long t; // Unix time
+    float v[2];      // Projected screen coordinates
+};
+typedef bool (*TrackProjection)(unsigned long t, float v[2]);
+TrackSample trackSamples[TRACK_SAMPLES_MAX]; // Shared by the plot pages, only used while a plot is rebuilt
+// Upcoming passes, shared by the main page banner and the pass table
+const int PASS_LIST_LENGTH = 12;     // Passes kept ahead (rows of the pass table)
+PassPredictor passPredictor;         // Only searches when passes have been consumed
+// Az/El plot page: the plot region is composited in bands, each pushed in one transaction, the labels around it are static
+const int AZEL_PLOT_X = 38;                                // Left margin
+const int AZEL_PLOT_Y = 20;                                // Top margin
+const int AZEL_PLOT_WIDTH = 410;                           // Plot width
+const int AZEL_PLOT_HEIGHT = 240;                          // Plot height
+const int AZEL_REGION_WIDTH = AZEL_PLOT_WIDTH + 1;         // Composited region, right gridline included
+const int AZEL_REGION_HEIGHT = AZEL_PLOT_Y + AZEL_PLOT_HEIGHT + 1; // From the top of the screen (TCA label) to the bottom gridline
+const int AZEL_BAND_ROWS = 16;                             // Rows per band, 411 x 16 pixels = 13 KB
+TFT_eSprite azElBand = TFT_eSprite(&tft);
+int16_t azElTrackAzY[AZEL_PLOT_WIDTH + 1];                 // Azimuth curve, one point per pixel column
+int16_t azElTrackElY[AZEL_PLOT_WIDTH + 1];                 // Elevation curve
+int8_t azElTrackWrap[AZEL_PLOT_WIDTH + 1];                 // Azimuth wraparound before the point: 1 up, -1 down
+int azElTrackPoints = 0;                                   // Points in the cached curve
+unsigned long azElTrackForPass = 0;                        // nextPassStart the curve was built for
+unsigned long azElLabelsForPass = 0;                       // nextPassStart the labels were drawn for
+// Polar plot page: the projected track is cached per pass, the position marker moves over the saved pixels beneath it
+const int POLAR_CENTER_X = 320;                            // Center of the polar chart
+const int POLAR_CENTER_Y = 160;                            // Center of the polar chart
+const int POLAR_RADIUS = 140;                              // Maximum radius for the outermost circle
+const int POLAR_TRACK_MAX = TRACK_SAMPLES_MAX;             // Projected points kept, repeated pixels are skipped
+int16_t polarTrackX[POLAR_TRACK_MAX];                      // Pass track in screen coordinates
+int16_t polarTrackY[POLAR_TRACK_MAX];
+int polarTrackPoints = 0;                                  // Points in the cached track
+int polarTrackTCA = -1;                                    // Index of the TCA point, -1 if none
+unsigned long polarTrackForPass = 0;                       // nextPassStart the track was built for
+unsigned long polarChartForPass = 0;                       // nextPassStart the chart on screen was drawn for
+const int POLAR_MARKER_SIZE = 9;                           // Square covered by the marker circles (radius 4)
+int16_t polarMarkerX = 0;                                  // Marker position on screen
+int16_t polarMarkerY = 0;
+bool polarMarkerShown = false;                             // Marker and its radial line drawn
+// Main page widgets: the value of each widget is a dirty rectangle, rendered into a sprite and pushed in one burst
+struct WidgetField
+{
+    int16_t x, y, w, h;    // Screen rectangle of the value
+    uint8_t font;          // TFT_eSPI font number
+    uint8_t chars;         // Character cells in the value
+    int16_t charX[6];      // Character cell positions relative to x
+    int16_t dotX;          // Fixed decimal point relative to x, -1 for none
+    char text[8];          // Text to show
+    uint16_t color;        // Color to show
+    bool dirty;            // Changed since the last push
+    bool registered;       // Listed in widgetFields
+};
+const int MAX_WIDGET_FIELDS = 8;
+WidgetField *widgetFields[MAX_WIDGET_FIELDS]; // Fields pushed by pushWidgetFields()
+int widgetFieldCount = 0;
+const int WIDGET_SPRITE_WIDTH = 150;          // Largest field: elevation/azimuth in font 7
+const int WIDGET_SPRITE_HEIGHT = 48;
+TFT_eSprite widgetSprite = TFT_eSprite(&tft); // Shared render buffer of the fields
+// Big clock glyph atlas: digits 0-9 with their ghost segments and the colon, rendered once from HB9IIU7segFonts
+const uint16_t CLOCK_GHOST_COLOR = 0x39a7; // Darker grey of the unlit segments https://rgbcolorpicker.com/565
+const int CLOCK_DIGIT_WIDTH = 46;          // Cell of the digit glyphs
+const int CLOCK_DIGIT_HEIGHT = 86;
+const int CLOCK_DIGIT_TOP = -85;           // Top row of the cell relative to the baseline
+const int CLOCK_COLON_WIDTH = 12;          // Cell of the colon glyph
+const int CLOCK_COLON_HEIGHT = 58;
+const int CLOCK_COLON_TOP = -71;
+const int CLOCK_COLON_GLYPH = 10;          // Atlas index of the colon, after the digits
+uint16_t *clockAtlas565 = NULL;            // RGB565 tiles in display byte order, in PSRAM when present
+uint8_t *clockAtlas2bpp = NULL;            // Otherwise 2 bits per pixel: black, digit color, ghost grey
+uint16_t *clockTileBuffer = NULL;          // A 2 bpp tile expanded to RGB565 for pushImage
+uint16_t clockAtlasColor = 0;              // Digit color the atlas was rendered with
+bool clockAtlasReady = false;
+// Multi-pass map page: the decoded map is kept in PSRAM when present, the overlays remember the pixels beneath them
+const int WORLD_MAP_WIDTH = 480;           // worldMap PNG, full screen
+const int WORLD_MAP_HEIGHT = 320;
+uint16_t *worldMapCache = NULL;            // Decoded map in display byte order (PSRAM only, 300 KB)
+bool worldMapCacheReady = false;
+#ifdef WORLD_MAP_RLE
+const uint8_t *worldMapRows[WORLD_MAP_HEIGHT]; // Without PSRAM, start of each row in worldMapRle (1.25 KB)
+bool worldMapRowsReady = false;
+uint16_t worldMapRow[WORLD_MAP_WIDTH];     // Last row decoded from worldMapRle, in display byte order
+int worldMapRowY = -1;
+#endif
+uint16_t *pngDrawCache = NULL;             // When set, pngDraw() also copies the decoded lines there
+struct MapOverlayPixel
+{
+    int16_t x, y;        // Screen position
+    uint16_t background; // Pixel beneath, restored before the next refresh
+};
+const int MAP_OVERLAY_MAX = 2048;          // Footprint, observer circle and ground track pixels that can be restored (12 KB)
+MapOverlayPixel mapOverlay[MAP_OVERLAY_MAX];
+int mapOverlayPixels = 0;
+bool mapOverlayComplete = false;           // Every overlay pixel on screen is recorded
+const int MAP_MARKER_SIZE = 11;            // Tile under the position marker circles (radius 5), in display byte order
+uint16_t mapMarkerTile[MAP_MARKER_SIZE * MAP_MARKER_SIZE];
+int16_t mapMarkerX = 0;                    // Tile rectangle, clipped to the screen
+int16_t mapMarkerY = 0;
+int16_t mapMarkerW = 0;
+int16_t mapMarkerH = 0;
+int mapMarkerIndex = 0;                    // Overlay pixels drawn before the marker (the footprint)
+const int MAP_WIDTH = 480;                 // Width of the map
+const int MAP_HEIGHT = 290;                // Height of the map
+const int MAP_OFFSET_Y = 30;               // Y-offset for the map (black banner)
+// Footprints on the map: small circles on the sphere, a unit circle table rotated to their center
+const float EARTH_RADIUS_KM = 6371.0;      // Earth's radius in kilometers
+const int SMALL_CIRCLE_POINTS = 72;        // Polyline vertices, every 5 degrees of bearing
+float smallCircleCos[SMALL_CIRCLE_POINTS]; // Unit circle table
+float smallCircleSin[SMALL_CIRCLE_POINTS];
+bool smallCircleTableReady = false;
+// Ground track of the map page: projected samples keyed by time over three orbits, only the tail is propagated
+struct GroundTrackSample
+{
+    unsigned long t; // Unix time
+    int16_t x, y;    // Screen position
+};
+const int GROUND_TRACK_ORBITS = 3;         // Orbits ahead, one color each
+const int GROUND_TRACK_MAX = 1024;         // Ring buffer of samples (8 KB)
+const unsigned long GROUND_TRACK_STEP = 20; // Seconds between samples, longer for slow orbits so they fit
+GroundTrackSample groundTrack[GROUND_TRACK_MAX];
+int groundTrackHead = 0;                   // Oldest sample
+int groundTrackCount = 0;
+unsigned long groundTrackStep = GROUND_TRACK_STEP;
+unsigned long groundTrackPeriod = 0;       // Orbital period in seconds, from revpday
+double groundTrackEpoch = 0;               // TLE epoch the samples belong to
+// Pass state machine: the next pass is only recalculated on a new TLE, at LOS, or when the cached pass is in the past
+enum PassState
+{
+    PASS_IDLE,      // No pass known yet, or none found
+    PASS_UPCOMING,  // nextPass* describes a pass that has not started
+    PASS_IN_PASS,   // Between AOS and LOS of the cached pass
+    PASS_POST_PASS  // LOS passed, waiting for the satellite to be below the horizon
+};
+const char *passStateNames[] = {"IDLE", "UPCOMING", "IN_PASS", "POST_PASS"};
+PassState passState = PASS_IDLE;
+double passStateEpoch = 0;            // TLE epoch the cached pass belongs to
+unsigned long passRetryTime = 0;      // Unix time of the next search when no pass was found
+const int PASS_RETRY_INTERVAL = 600;  // Seconds between searches while no pass is known
+// Loop timing, printed every LOOP_STATS_INTERVAL seconds to check the CPU time of loop()
+const int LOOP_STATS_INTERVAL = 60;
+unsigned long passCalculations = 0;    // calculateNextPass calls since the last report
+unsigned long passCalculationMicros = 0; // Time spent in calculateNextPass since the last report
+unsigned long loopBusyMicros = 0;      // Time spent in loop() since the last report
+unsigned long loopCount = 0;           // loop() calls since the last report
+// WebSocket telemetry: frames are written into fixed buffers, the loop builds no String.
+// The buffers are sized for the pass track, the largest frame.
+const size_t TELEMETRY_FRAME_SIZE = 3072;
+char telemetryFrame[TELEMETRY_FRAME_SIZE];
+size_t telemetryLength = 0;
+unsigned long telemetryFrames = 0;         // Frames sent since the last report
+unsigned long telemetryHeapAllocations = 0; // Frames during which encoding lowered the free heap, should stay 0
+// Binary telemetry: clients sending "subscribe msgpack" get the frame as MessagePack, plus the next pass
+enum TelemetryFormat
+{
+    TELEMETRY_NONE,    // No client on this slot, or unsubscribed
+    TELEMETRY_JSON,    // Text frames, the default for backward compatibility
+    TELEMETRY_MSGPACK  // Binary MessagePack frames
+};
+const size_t TELEMETRY_PACKED_SIZE = 2048;
+uint8_t telemetryPacked[TELEMETRY_PACKED_SIZE];
+size_t telemetryPackedLength = 0;
+// Telemetry fields a client can select, the bit numbers of TelemetryClient::fields
+enum TelemetryField
+{
+    TELEMETRY_SAT_NAME,
+    TELEMETRY_TIME,
+    TELEMETRY_ALTITUDE,
+    TELEMETRY_AZIMUTH,
+    TELEMETRY_ELEVATION,
+    TELEMETRY_LATITUDE,
+    TELEMETRY_LONGITUDE,
+    TELEMETRY_DISTANCE,
+    TELEMETRY_SUN_AZIMUTH,
+    TELEMETRY_SUN_ELEVATION,
+    TELEMETRY_PASS,      // Next pass: state, AOS, TCA, LOS, max elevation, AOS/LOS azimuth
+    TELEMETRY_TIMESTAMP, // Unix time of the position, with milliseconds
+    TELEMETRY_RANGE_RATE, // km/s, positive when the satellite moves away
+    TELEMETRY_FIELD_COUNT
+};
+const char *telemetryFieldNames[] = {"satName", "time", "altitude", "azimuth", "elevation", "latitude", "longitude",
+                                     "distance", "sunAzimuth", "sunElevation", "pass", "timestamp", "rangeRate"};
+const uint16_t TELEMETRY_FIELDS_JSON = (1 << TELEMETRY_PASS) - 1;                      // The original JSON frame
+const uint16_t TELEMETRY_FIELDS_MSGPACK = TELEMETRY_FIELDS_JSON | 1 << TELEMETRY_PASS; // Default binary frame
+const double TELEMETRY_RATE_MIN = 0.2;  // Hz
+const double TELEMETRY_RATE_MAX = 10;   // Hz
+const int PASS_TRACK_POINTS = 180;      // Maximum points of the pass track sent to subscribers
+const int PASS_TRACK_STEP = 5;          // Minimum seconds between two points of the pass track
+// Subscription of a WebSocket client, served by serviceTelemetry() whatever page is shown
+struct TelemetryClient
+{
+    TelemetryFormat format = TELEMETRY_NONE;
+    uint16_t fields = 0;             // Bit set of TelemetryField
+    unsigned long interval = 1000;   // Milliseconds between frames
+    unsigned long lastSent = 0;      // millis() of the last frame
+    bool passTrack = false;          // Also send the track of each pass once
+    unsigned long passTrackSent = 0; // nextPassStart of the last track sent
+};
+TelemetryClient telemetryClients[WEBSOCKETS_SERVER_CLIENT_MAX];
+// Position sent to the subscribers, a copy so that the pages keep drawing the 1 Hz position in sat
+struct TelemetryPosition
+{
+    double satAz, satEl, satDist, satLat, satLon, satAlt, satRangeRate;
+};
+TelemetryPosition telemetryPosition;
+double telemetryTime = 0; // Unix time of telemetryPosition, with the milliseconds since unixtime changed
+// Rotator control: rotctld protocol server on ROTCTLD_PORT, and the optional push to a rotctld (config.h)
+const int ROTCTLD_CLIENTS_MAX = 2;
+const unsigned long ROTATOR_PUSH_INTERVAL = 500;  // Milliseconds between two targets in push mode
+const double ROTATOR_PUSH_STEP = 0.5;             // Degrees the target must move before it is sent again
+const unsigned long OUTPUT_RETRY_INTERVAL = 10000; // Milliseconds between connection attempts to the rotctld or rigctld
+const int OUTPUT_CONNECT_TIMEOUT = 200;           // Milliseconds, the longest loop() waits for them
+struct RotctldClient
+{
+    WiFiClient client;
+    char line[64];  // Command being received
+    int length = 0;
+};
+WiFiServer rotctldServer(ROTCTLD_PORT);
+RotctldClient rotctldClients[ROTCTLD_CLIENTS_MAX];
+WiFiClient rotatorPush; // Connection to the rotctld in push mode
+// Doppler correction: frequencies of the tracked satellite's transponder (config.h), sent to a rigctld
+const double SPEED_OF_LIGHT = 299792.458; // km/s, like the range rate
+const Transponder *transponder = NULL;    // Entry of TRANSPONDERS for satelliteCatalogueNumber, NULL when none
+WiFiClient rigctld;
 bool speakerisON = true;
 //____________________________________________________________________
 void displaySysInfo();
@@ -75,9 +333,19 @@ void connectToWiFi();
 void initializeBuzzer();
 void displaySplashScreen(int duration);
 void pngDraw(PNGDRAW *pDraw);
+bool allocatePNGBatches();
+void releasePNGBatches();
+void flushPNGBatch();
+int decodePNG();
+bool drawRleImage(const uint8_t *image, const uint8_t **rowIndex = NULL);
+const uint8_t *decodeRleRow(const uint8_t *image, const uint8_t *data, uint16_t *line);
 void displayMainPage();
 void getOrbitNumber(time_t t);
 void updateBigClock(bool refreshBecauseReturningFromOtherPage = false);
+void placeWidgetField(WidgetField &field, const int *xPos, int chars, int y, uint8_t font, int dotX);
+void setWidgetField(WidgetField &field, const char *text, uint16_t color, bool refresh);
+void renderWidgetField(TFT_eSPI &canvas, WidgetField &field, int x0, int y0);
+void pushWidgetFields();
 void displayElevation(float number, int x, int y, uint16_t color, bool refreshBecauseReturningFromOtherPage);
 void displayAzimuth(float number, int x, int y, uint16_t color, bool refreshBecauseReturningFromOtherPage);
 void displayLatitude(float number, int x, int y, uint16_t color, bool refreshBecauseReturningFromOtherPage);
@@ -87,20 +355,75 @@ void displayDistance(int number, int x, int y, uint16_t color, bool refreshBecau
 void displayLTLEage(int y, bool refreshBecauseReturningFromOtherPage);
 void displayClassicClock();
 void display7segmentClock(int xOffset, int yOffset, uint16_t textColor, bool refreshBecauseReturningFromOtherPage);
+size_t clockGlyphCell(int glyph, int &w, int &h, int &top);
+bool buildClockAtlas(uint16_t textColor);
+void pushClockGlyph(int glyph, int x, int baseline);
 void displayOrbitNumber(int number, int x, int y, uint16_t color, bool refreshBecauseReturningFromOtherPage);
 void calculateNextPass();
+void updatePassState();
+void setPassState(PassState newState);
+void reportLoopTiming();
+void telemetryAppend(const char *text);
+void telemetryAppendFixed(double value);
+void formatTelemetryTime(char *time);
+double telemetryNumber(int field);
+size_t encodeTelemetry(uint16_t fields);
+void msgpackAppend(const uint8_t *data, size_t length);
+void msgpackAppendByte(uint8_t value);
+void msgpackAppendString(const char *text);
+void msgpackAppendUint(uint32_t value);
+void msgpackAppendFloat(double value);
+void msgpackAppendDouble(double value);
+void msgpackAppendArray(uint16_t count);
+size_t encodeTelemetryMsgpack(uint16_t fields);
+int passTrackStep();
+size_t encodePassTrack(TelemetryFormat format);
+double fractionalUnixtime();
+void updateTelemetryPosition();
+void serviceTelemetry();
+void subscribeTelemetry(uint8_t num, char *command);
+void rotatorTarget(double unixSeconds, double &azimuth, double &elevation);
+void rotctldCommand(WiFiClient &client, char *line);
+bool connectOutput(WiFiClient &client, const char *host, uint16_t port, unsigned long &lastAttempt);
+void pushRotatorTarget();
+void serviceRotator();
+void startRotctld();
+void findTransponder();
+void serviceDoppler();
+void updatePassTrack();
+void updateSatPosition();
 String formatTimeOnly(unsigned long epochTime, bool isLocal);
 String formatDate(unsigned long epochTime, bool isLocal);
 void displayNextPassTime(unsigned long durationInSec, int x, int y, uint16_t color, bool refresh);
 String displayRemainingVisibleTimeinMMSS(int delta);
 String formatTime(unsigned long epochTime, bool isLocal);
 void beepsBeforeVisibility();
-void displayAzElPlotPage();
-void displayPolarPlotPage();
+int refineTrackSegment(const TrackSample &a, const TrackSample &b, TrackProjection project, TrackSample *samples, int count, int maxSamples, int depth);
+int sampleTrack(unsigned long start, unsigned long end, TrackProjection project, TrackSample *samples, int count, int maxSamples);
+bool projectAzElPoint(unsigned long t, float v[2]);
+bool projectPolarPoint(unsigned long t, float v[2]);
+void buildAzElPlotTrack();
+void drawAzElPlot(TFT_eSPI &canvas, int x0, int y0);
+void pushAzElPlot();
+void displayAzElPlotPage(bool fullRedraw = true);
+void buildPolarTrack();
+void drawPolarChart();
+void movePolarMarker();
+void displayPolarPlotPage(bool fullRedraw = true);
 String formatWithSeparator(unsigned long number);
 void displayTableNext10Passes();
-void displayMapWithMultiPasses();
+uint16_t mapBackgroundPixel(int x, int y);
+void plotMapPixel(int x, int y, uint16_t color);
+void restoreMapOverlay();
+void updateGroundTrack(unsigned long now);
+float visibilityRadius(float altitudeKm, float elevationDeg);
+void plotMapLine(int x0, int y0, int x1, int y1, uint16_t color);
+void plotMapSegment(float lat0, float lon0, float lat1, float lon1, uint16_t color);
+void drawSmallCircle(float centerLat, float centerLon, float radius, uint16_t color);
+void displayMapWithMultiPasses(bool fullRedraw = true);
 void displayEquirectangularWorlsMap();
+void drawMapTitles();
+bool mapBackgroundRow(int x, int y, int w, uint16_t *line);
 void displayPExpedition72image();
 void calibrateTFTscreen();
 void checkAndApplyTFTCalibrationData(bool recalibrate);
@@ -510,6 +833,14 @@ bool syncTimeFromNTP(bool displayOnTFT)
 }
 void displayPExpedition72image()
 {
+#ifdef EXPEDITION72_RLE
+    tft.startWrite();
+    uint32_t dt = millis();
+    drawRleImage(expedition72Rle);
+    Serial.print(millis() - dt);
+    Serial.println("ms (RLE)");
+    tft.endWrite();
+#else
     // https://notisrac.github.io/FileToCArray/
     int16_t rc = png.openFLASH((uint8_t *)expedition72, sizeof(expedition72), pngDraw);
     if (rc == PNG_SUCCESS)
@@ -518,11 +849,12 @@ void displayPExpedition72image()
         Serial.printf("image specs: (%d x %d), %d bpp, pixel type: %d\n", png.getWidth(), png.getHeight(), png.getBpp(), png.getPixelType());
         tft.startWrite();
         uint32_t dt = millis();
-        rc = png.decode(NULL, 0);
+        rc = decodePNG();
         Serial.print(millis() - dt);
         Serial.println("ms");
         tft.endWrite();
     }
+#endif
 }
 String processTLE(String line1charArray)
 {
@@ -735,6 +1067,16 @@ void displaySplashScreen(int duration)
 {
     digitalWrite(TFT_BLP, LOW);
 
+#ifdef FANCY_SPLASH_RLE
+    logWithBoxFrame("Displaying Splash Screen");
+    tft.startWrite();
+    uint32_t dt = millis();
+    drawRleImage(fancySplashRle);
+    Serial.print("Displayed in ");
+    Serial.print(millis() - dt);
+    Serial.println(" ms (RLE)");
+    tft.endWrite();
+#else
     // https://notisrac.github.io/FileToCArray/
     int16_t rc = png.openFLASH((uint8_t *)fancySplash, sizeof(fancySplash), pngDraw);
 
@@ -745,12 +1087,13 @@ void displaySplashScreen(int duration)
         Serial.printf("image specs: (%d x %d), %d bpp, pixel type: %d\n", png.getWidth(), png.getHeight(), png.getBpp(), png.getPixelType());
         tft.startWrite();
         uint32_t dt = millis();
-        rc = png.decode(NULL, 0);
+        rc = decodePNG();
         Serial.print("Displayed in ");
         Serial.print(millis() - dt);
         Serial.println(" ms");
         tft.endWrite();
     }
+#endif
 
     digitalWrite(TFT_BLP, HIGH);
 
@@ -758,9 +1101,167 @@ void displaySplashScreen(int duration)
 }
 void pngDraw(PNGDRAW *pDraw)
 {
-    uint16_t lineBuffer[480];
+    if (pngBatch == NULL || pDraw->iWidth > PNG_BATCH_WIDTH)
+    {
+        // No batch buffer, one pushImage per row
+        uint16_t lineBuffer[480];
+        png.getLineAsRGB565(pDraw, lineBuffer, PNG_RGB565_BIG_ENDIAN, 0xffffffff);
+        tft.pushImage(0, 0 + pDraw->y, pDraw->iWidth, 1, lineBuffer);
+        if (pngDrawCache != NULL && pDraw->y < WORLD_MAP_HEIGHT && pDraw->iWidth <= WORLD_MAP_WIDTH)
+        {
+            memcpy(pngDrawCache + pDraw->y * WORLD_MAP_WIDTH, lineBuffer, pDraw->iWidth * sizeof(uint16_t));
+        }
+        return;
+    }
+
+    if (pngBatchRows == 0)
+    {
+        pngBatchY = pDraw->y;
+        pngBatchWidth = pDraw->iWidth;
+    }
+    uint16_t *lineBuffer = pngBatch + pngBatchRows * pngBatchWidth;
     png.getLineAsRGB565(pDraw, lineBuffer, PNG_RGB565_BIG_ENDIAN, 0xffffffff);
-    tft.pushImage(0, 0 + pDraw->y, pDraw->iWidth, 1, lineBuffer);
+    if (pngDrawCache != NULL && pDraw->y < WORLD_MAP_HEIGHT && pDraw->iWidth <= WORLD_MAP_WIDTH)
+    {
+        memcpy(pngDrawCache + pDraw->y * WORLD_MAP_WIDTH, lineBuffer, pDraw->iWidth * sizeof(uint16_t));
+    }
+    pngBatchRows++;
+    if (pngBatchRows == PNG_BATCH_ROWS)
+    {
+        flushPNGBatch();
+    }
+}
+void flushPNGBatch()
+{
+    // Blocking: ILI9488 pixels are sent as 18-bit and TFT_eSPI has no DMA path for them
+    if (pngBatchRows > 0)
+    {
+        tft.pushImage(0, pngBatchY, pngBatchWidth, pngBatchRows, pngBatch);
+        pngBatchRows = 0;
+    }
+}
+bool allocatePNGBatches()
+{
+    // Batch buffer for the duration of one image
+    pngBatch = (uint16_t *)malloc(PNG_BATCH_WIDTH * PNG_BATCH_ROWS * sizeof(uint16_t));
+    pngBatchRows = 0;
+    if (pngBatch == NULL)
+    {
+        Serial.println("PNG: not enough memory for the batch, pushing row by row");
+        return false;
+    }
+    return true;
+}
+void releasePNGBatches()
+{
+    if (pngBatch != NULL)
+    {
+        flushPNGBatch(); // Last rows
+    }
+    free(pngBatch);
+    pngBatch = NULL;
+}
+int decodePNG()
+{
+    // png.decode() for an image opened with pngDraw, within startWrite()/endWrite()
+    allocatePNGBatches();
+    int rc = png.decode(NULL, 0);
+    releasePNGBatches();
+    return rc;
+}
+bool drawRleImage(const uint8_t *image, const uint8_t **rowIndex)
+{
+    // Streams an image converted by tools/assets.py to the top left of the screen, within startWrite()/endWrite().
+    // Rows are expanded into the PNG batch. When rowIndex is given, the start of each row is recorded there.
+    if (image[0] != 'R' || image[1] != 'L')
+    {
+        return false;
+    }
+    uint8_t format = image[2];
+    int width = image[4] | image[5] << 8;
+    int height = image[6] | image[7] << 8;
+    int paletteEntries = image[8] | image[9] << 8;
+    const uint8_t *data = image + 10 + 2 * paletteEntries;
+    if (width > PNG_BATCH_WIDTH || format > 2)
+    {
+        return false;
+    }
+
+    bool batches = allocatePNGBatches();
+    uint16_t rowBuffer[480];
+    for (int y = 0; y < height; y++)
+    {
+        if (batches && pngBatchRows == 0)
+        {
+            pngBatchY = y;
+            pngBatchWidth = width;
+        }
+        uint16_t *line = batches ? pngBatch + pngBatchRows * width : rowBuffer;
+        if (rowIndex != NULL)
+        {
+            rowIndex[y] = data;
+        }
+        data = decodeRleRow(image, data, line);
+
+        if (pngDrawCache != NULL && y < WORLD_MAP_HEIGHT && width <= WORLD_MAP_WIDTH)
+        {
+            memcpy(pngDrawCache + y * WORLD_MAP_WIDTH, line, width * sizeof(uint16_t));
+        }
+        if (!batches)
+        {
+            tft.pushImage(0, y, width, 1, line);
+        }
+        else if (++pngBatchRows == PNG_BATCH_ROWS)
+        {
+            flushPNGBatch();
+        }
+    }
+    releasePNGBatches();
+    return true;
+}
+const uint8_t *decodeRleRow(const uint8_t *image, const uint8_t *data, uint16_t *line)
+{
+    // Expands the row of a drawRleImage() image starting at data into line, returns the start of the next row.
+    // Literal packets are copied, runs are filled.
+    uint8_t format = image[2];
+    int width = image[4] | image[5] << 8;
+    const uint8_t *palette = image + 10;
+
+    // Pixels are stored in display byte order, they are copied as bytes
+    if (format == 0)
+    {
+        memcpy(line, data, width * sizeof(uint16_t));
+        return data + width * sizeof(uint16_t);
+    }
+    for (int x = 0; x < width;)
+    {
+        uint8_t packet = *data++;
+        int count = min((packet & 0x7f) + 1, width - x);
+        if (packet & 0x80)
+        {
+            uint16_t color;
+            memcpy(&color, format == 1 ? data : palette + 2 * *data, sizeof(color));
+            data += format == 1 ? 2 : 1;
+            for (int i = 0; i < count; i++)
+            {
+                line[x + i] = color;
+            }
+        }
+        else if (format == 1)
+        {
+            memcpy(line + x, data, count * sizeof(uint16_t));
+            data += count * sizeof(uint16_t);
+        }
+        else
+        {
+            for (int i = 0; i < count; i++)
+            {
+                memcpy(line + x + i, palette + 2 * *data++, sizeof(uint16_t));
+            }
+        }
+        x += count;
+    }
+    return data;
 }
 void displayUsedElements()
 {
@@ -820,16 +1321,47 @@ void displayMainPage()
     displayLatitude(sat.satLat, 320, startYmain, TFT_GOLD, refreshBecauseReturningFromOtherPage);
     displayLongitude(sat.satLon, 320, startYmain + deltaY, TFT_GOLD, refreshBecauseReturningFromOtherPage);
     displayLTLEage(startYmain + 2 * deltaY, refreshBecauseReturningFromOtherPage);
+    pushWidgetFields(); // Values that changed since the last refresh
 
     // Managing the bottom banner
     int lowerBannerY = 295;
     static bool first_time_below = true;
     static bool first_time_above = true;
+    static bool noPassBannerShown = false;
+    if (nextPassStart == 0)
+    {
+        // Nothing to count down to: geostationary satellite, or no pass found
+        if (noPassBannerShown == false || refreshBecauseReturningFromOtherPage == true)
+        {
+            tft.fillRect(0, 295, 480, 50, TFT_BLACK);
+            tft.setCursor(50, lowerBannerY);
+            tft.setTextColor(TFT_CYAN);
+            if (passPredictor.alwaysvisible())
+            {
+                tft.print("Satellite is always above horizon");
+            }
+            else if (passPredictor.nevervisible())
+            {
+                tft.print("Satellite never rises above horizon");
+            }
+            else
+            {
+                tft.print("No pass found");
+            }
+            noPassBannerShown = true;
+        }
+        return;
+    }
+    if (noPassBannerShown == true)
+    {
+        noPassBannerShown = false;
+        first_time_below = true;
+        first_time_above = true;
+    }
     if (sat.satEl < 0)
 
     {
-        calculateNextPass(); // only if below horizon, otherwise we get a problem with next pass when visible
-
+        // the next pass is kept up to date by updatePassState() in loop()
         int shifting = 50;
         if (first_time_below == true || refreshBecauseReturningFromOtherPage == true)
         {
@@ -958,12 +1490,87 @@ void updateBigClock(bool refreshBecauseReturningFromOtherPage)
         displayClassicClock();
     }
 }
+void placeWidgetField(WidgetField &field, const int *xPos, int chars, int y, uint8_t font, int dotX)
+{
+    // Rectangle from the first character cell to the end of the last one, full font height
+    field.x = xPos[0];
+    field.y = y;
+    field.font = font;
+    field.chars = chars;
+    for (int i = 0; i < chars; i++)
+    {
+        field.charX[i] = xPos[i] - xPos[0];
+    }
+    field.dotX = dotX >= 0 ? dotX - xPos[0] : -1;
+    field.w = min(field.charX[chars - 1] + tft.textWidth("8", font), WIDGET_SPRITE_WIDTH);
+    field.h = min((int)tft.fontHeight(font), WIDGET_SPRITE_HEIGHT);
+    if (!field.registered && widgetFieldCount < MAX_WIDGET_FIELDS)
+    {
+        widgetFields[widgetFieldCount++] = &field;
+        field.registered = true;
+    }
+    field.dirty = true;
+}
+void setWidgetField(WidgetField &field, const char *text, uint16_t color, bool refresh)
+{
+    if (refresh || color != field.color || strncmp(text, field.text, sizeof(field.text)) != 0)
+    {
+        strncpy(field.text, text, sizeof(field.text) - 1);
+        field.text[sizeof(field.text) - 1] = '\0';
+        field.color = color;
+        field.dirty = true;
+    }
+}
+void renderWidgetField(TFT_eSPI &canvas, WidgetField &field, int x0, int y0)
+{
+    canvas.fillRect(x0, y0, field.w, field.h, TFT_BLACK);
+    canvas.setTextSize(1);
+    canvas.setTextFont(field.font);
+    canvas.setTextColor(field.color, TFT_BLACK);
+    if (field.dotX >= 0)
+    {
+        canvas.drawString(".", x0 + field.dotX, y0);
+    }
+    for (int i = 0; i < field.chars && field.text[i] != '\0'; i++)
+    {
+        if (field.text[i] != ' ')
+        {
+            canvas.drawChar(field.text[i], x0 + field.charX[i], y0);
+        }
+    }
+}
+void pushWidgetFields()
+{
+    // One SPI burst per changed value, nothing is erased on the panel so there is no flicker
+    if (!widgetSprite.created())
+    {
+        widgetSprite.createSprite(WIDGET_SPRITE_WIDTH, WIDGET_SPRITE_HEIGHT);
+    }
+    for (int i = 0; i < widgetFieldCount; i++)
+    {
+        WidgetField &field = *widgetFields[i];
+        if (!field.dirty)
+        {
+            continue;
+        }
+        if (widgetSprite.created())
+        {
+            renderWidgetField(widgetSprite, field, 0, 0);
+            widgetSprite.pushSprite(field.x, field.y, 0, 0, field.w, field.h);
+        }
+        else
+        {
+            renderWidgetField(tft, field, field.x, field.y); // Not enough memory for the sprite
+        }
+        field.dirty = false;
+    }
+}
 void displayElevation(float number, int x, int y, uint16_t color, bool refreshBecauseReturningFromOtherPage)
 {
     tft.setTextSize(1);
     tft.setTextFont(7);
 
-    static char previousOutput[6] = "     ";   // Previous state (5 characters + null terminator) 999.9
+    static WidgetField valueField;             // Value rectangle, pushed by pushWidgetFields()
     static uint16_t previousColor = TFT_GREEN; // Track the last color used
     static bool isInitiated = false;           // Track initialization of static elements
     char output[6] = "     ";                  // Current output (5 characters + null terminator) 999.9
@@ -1019,44 +1626,23 @@ void displayElevation(float number, int x, int y, uint16_t color, bool refreshBe
 
         tft.setTextFont(7);
         tft.setTextColor(color, TFT_BLACK);
-        tft.drawString(".", xPos[4], y); // Decimal point is fixed at xPos[4]
         tft.setFreeFont(&FreeMonoBold12pt7b);
         tft.drawString("o", xPos[4] + 40, y - 5); // Decimal point is fixed at xPos[4]
         tft.setTextFont(7);
 
+        placeWidgetField(valueField, xPos, 5, y, 7, xPos[4]); // Decimal point is fixed at xPos[4]
         isInitiated = true;
     }
 
-    // Update only changed characters or redraw all if refreshBecauseReturningFromOtherPage is triggered
-    for (int i = 0; i < 6; i++)
-    { // Loop through each character of the formatted number
-        if (output[i] != previousOutput[i] || refreshBecauseReturningFromOtherPage)
-        {
-            // Print the previous character in black to erase it
-            if (previousOutput[i] != ' ')
-            {
-                tft.setTextColor(TFT_BLACK, TFT_BLACK);
-                tft.drawChar(previousOutput[i], xPos[i], y);
-            }
-
-            // Draw the new character
-            if (output[i] != ' ')
-            {
-                tft.setTextColor(color, TFT_BLACK);
-                tft.drawChar(output[i], xPos[i], y);
-            }
-
-            // Update previous state
-            previousOutput[i] = output[i];
-        }
-    }
+    // Only marks the value dirty, it is rendered and pushed in one burst by pushWidgetFields()
+    setWidgetField(valueField, output, color, refreshBecauseReturningFromOtherPage);
 }
 void displayAzimuth(float number, int x, int y, uint16_t color, bool refreshBecauseReturningFromOtherPage)
 {
     tft.setTextSize(1);
     tft.setTextFont(7);
 
-    static char previousOutput[6] = "     ";   // Previous state (5 characters + null terminator) 999.9
+    static WidgetField valueField;             // Value rectangle, pushed by pushWidgetFields()
     static uint16_t previousColor = TFT_GREEN; // Track the last color used
     static bool isInitiated = false;           // Track initialization of static elements
     char output[6] = "     ";                  // Current output (5 characters + null terminator) 999.9
@@ -1112,44 +1698,23 @@ void displayAzimuth(float number, int x, int y, uint16_t color, bool refreshBeca
 
         tft.setTextFont(7);
         tft.setTextColor(color, TFT_BLACK);
-        tft.drawString(".", xPos[4], y); // Decimal point is fixed at xPos[4]
         tft.setFreeFont(&FreeMonoBold12pt7b);
         tft.drawString("o", xPos[4] + 40, y - 5); // Decimal point is fixed at xPos[4]
         tft.setTextFont(7);
 
+        placeWidgetField(valueField, xPos, 5, y, 7, xPos[4]); // Decimal point is fixed at xPos[4]
         isInitiated = true;
     }
 
-    // Update only changed characters or redraw all if refreshBecauseReturningFromOtherPage is triggered
-    for (int i = 0; i < 6; i++)
-    { // Loop through each character of the formatted number
-        if (output[i] != previousOutput[i] || refreshBecauseReturningFromOtherPage)
-        {
-            // Print the previous character in black to erase it
-            if (previousOutput[i] != ' ')
-            {
-                tft.setTextColor(TFT_BLACK, TFT_BLACK);
-                tft.drawChar(previousOutput[i], xPos[i], y);
-            }
-
-            // Draw the new character
-            if (output[i] != ' ')
-            {
-                tft.setTextColor(color, TFT_BLACK);
-                tft.drawChar(output[i], xPos[i], y);
-            }
-
-            // Update previous state
-            previousOutput[i] = output[i];
-        }
-    }
+    // Only marks the value dirty, it is rendered and pushed in one burst by pushWidgetFields()
+    setWidgetField(valueField, output, color, refreshBecauseReturningFromOtherPage);
 }
 void displayLatitude(float number, int x, int y, uint16_t color, bool refreshBecauseReturningFromOtherPage)
 {
     tft.setTextSize(1);
     tft.setTextFont(4);
 
-    static char previousOutput[7] = "      ";  // Previous state (6 characters + null terminator)
+    static WidgetField valueField;             // Value rectangle, pushed by pushWidgetFields()
     static uint16_t previousColor = TFT_GREEN; // Track the last color used
     static bool isInitiated = false;           // Track initialization of static elements
     char output[7] = "      ";                 // Current output (6 characters + null terminator)
@@ -1184,43 +1749,22 @@ void displayLatitude(float number, int x, int y, uint16_t color, bool refreshBec
     if (!isInitiated || refreshBecauseReturningFromOtherPage)
     {
         tft.setTextColor(color, TFT_BLACK);
-        tft.drawString(".", xPos[4], y);         // Decimal point is fixed at xPos[4]
         tft.drawString("deg.", xPos[5] + 20, y); // Unit
         tft.drawString("Lat.", xPos[0] - 45, y); // Unit
 
+        placeWidgetField(valueField, xPos, 6, y, 4, xPos[4]); // Decimal point is fixed at xPos[4]
         isInitiated = true;
     }
 
-    // Update only changed characters or redraw all if refreshBecauseReturningFromOtherPage is triggered
-    for (int i = 0; i < 6; i++)
-    { // Loop through each character of the formatted number
-        if (output[i] != previousOutput[i] || refreshBecauseReturningFromOtherPage)
-        {
-            // Print the previous character in black to erase it
-            if (previousOutput[i] != ' ')
-            {
-                tft.setTextColor(TFT_BLACK, TFT_BLACK);
-                tft.drawChar(previousOutput[i], xPos[i], y);
-            }
-
-            // Draw the new character
-            if (output[i] != ' ')
-            {
-                tft.setTextColor(color, TFT_BLACK);
-                tft.drawChar(output[i], xPos[i], y);
-            }
-
-            // Update previous state
-            previousOutput[i] = output[i];
-        }
-    }
+    // Only marks the value dirty, it is rendered and pushed in one burst by pushWidgetFields()
+    setWidgetField(valueField, output, color, refreshBecauseReturningFromOtherPage);
 }
 void displayLongitude(float number, int x, int y, uint16_t color, bool refreshBecauseReturningFromOtherPage)
 {
     tft.setTextSize(1);
     tft.setTextFont(4);
 
-    static char previousOutput[7] = "      ";  // Previous state (6 characters + null terminator)
+    static WidgetField valueField;             // Value rectangle, pushed by pushWidgetFields()
     static uint16_t previousColor = TFT_GREEN; // Track the last color used
     static bool isInitiated = false;           // Track initialization of static elements
     char output[7] = "      ";                 // Current output (6 characters + null terminator)
@@ -1255,42 +1799,21 @@ void displayLongitude(float number, int x, int y, uint16_t color, bool refreshBe
     if (!isInitiated || refreshBecauseReturningFromOtherPage)
     {
         tft.setTextColor(color, TFT_BLACK);
-        tft.drawString(".", xPos[4], y);         // Decimal point is fixed at xPos[4]
         tft.drawString("deg.", xPos[5] + 20, y); // Unit
         tft.drawString("Lon.", xPos[0] - 45, y); // Unit
+        placeWidgetField(valueField, xPos, 6, y, 4, xPos[4]); // Decimal point is fixed at xPos[4]
         isInitiated = true;
     }
 
-    // Update only changed characters or redraw all if refreshBecauseReturningFromOtherPage is triggered
-    for (int i = 0; i < 6; i++)
-    { // Loop through each character of the formatted number
-        if (output[i] != previousOutput[i] || refreshBecauseReturningFromOtherPage)
-        {
-            // Print the previous character in black to erase it
-            if (previousOutput[i] != ' ')
-            {
-                tft.setTextColor(TFT_BLACK, TFT_BLACK);
-                tft.drawChar(previousOutput[i], xPos[i], y);
-            }
-
-            // Draw the new character
-            if (output[i] != ' ')
-            {
-                tft.setTextColor(color, TFT_BLACK);
-                tft.drawChar(output[i], xPos[i], y);
-            }
-
-            // Update previous state
-            previousOutput[i] = output[i];
-        }
-    }
+    // Only marks the value dirty, it is rendered and pushed in one burst by pushWidgetFields()
+    setWidgetField(valueField, output, color, refreshBecauseReturningFromOtherPage);
 }
 void displayAltitude(int number, int x, int y, uint16_t color, bool refreshBecauseReturningFromOtherPage)
 {
     tft.setTextSize(1);
     tft.setTextFont(4);
 
-    static char previousOutput[7] = "      ";  // Previous state (6 characters + null terminator) 12'456
+    static WidgetField valueField;             // Value rectangle, pushed by pushWidgetFields()
     static uint16_t previousColor = TFT_GREEN; // Track the last color used
     static bool isInitiated = false;           // Track initialization of static elements
     char output[7] = "      ";                 // Current output (6 characters + null terminator)
@@ -1346,34 +1869,12 @@ void displayAltitude(int number, int x, int y, uint16_t color, bool refreshBecau
         tft.setTextColor(color, TFT_BLACK);
         tft.drawString("km", xPos[5] + 24, y);
         tft.drawString("Altitude:", x, y);
+        placeWidgetField(valueField, xPos, 6, y, 4, -1);
         isInitiated = true;
     }
 
-    // Update only changed characters or redraw all if refreshBecauseReturningFromOtherPage is triggered
-    for (int i = 0; i < 6; i++)
-    { // Loop through each character of the formatted number
-        // Serial.print(output[i]);
-        // Serial.print(" ");
-        if (output[i] != previousOutput[i] || refreshBecauseReturningFromOtherPage)
-        {
-            // Print the previous character in black to erase it
-            if (previousOutput[i] != ' ')
-            {
-                tft.setTextColor(TFT_BLACK, TFT_BLACK);
-                tft.drawChar(previousOutput[i], xPos[i], y);
-            }
-
-            // Draw the new character
-            if (output[i] != ' ')
-            {
-                tft.setTextColor(color, TFT_BLACK);
-                tft.drawChar(output[i], xPos[i], y);
-            }
-
-            // Update previous state
-            previousOutput[i] = output[i];
-        }
-    }
+    // Only marks the value dirty, it is rendered and pushed in one burst by pushWidgetFields()
+    setWidgetField(valueField, output, color, refreshBecauseReturningFromOtherPage);
     Serial.println();
 }
 void displayLTLEage(int y, bool refreshBecauseReturningFromOtherPage)
@@ -1441,42 +1942,186 @@ void displayClassicClock()
     // Update previousTime to the new time
     previousTime = currentTime;
 }
-void display7segmentClock(int xOffset, int yOffset, uint16_t textColor, bool refreshBecauseReturningFromOtherPage)
+size_t clockGlyphCell(int glyph, int &w, int &h, int &top)
 {
-    // Static variables to track previous state and colon visibility
-    static int previousArray[6] = {-1, -1, -1, -1, -1, -1}; // Initialize previous digit array
-    if (refreshBecauseReturningFromOtherPage == true)
+    // Size of the glyph cell and its pixel offset in the atlas
+    if (glyph == CLOCK_COLON_GLYPH)
     {
-        for (int i = 0; i < 6; i++)
+        w = CLOCK_COLON_WIDTH;
+        h = CLOCK_COLON_HEIGHT;
+        top = CLOCK_COLON_TOP;
+    }
+    else
+    {
+        w = CLOCK_DIGIT_WIDTH;
+        h = CLOCK_DIGIT_HEIGHT;
+        top = CLOCK_DIGIT_TOP;
+    }
+    return (size_t)glyph * CLOCK_DIGIT_WIDTH * CLOCK_DIGIT_HEIGHT;
+}
+bool buildClockAtlas(uint16_t textColor)
+{
+    // Mapped characters for 0-9: the ghost (unlit) segments of each digit, 'H' has none
+    const char mappedChars[10] = {'@', 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I'};
+    const size_t atlasPixels = (size_t)CLOCK_COLON_GLYPH * CLOCK_DIGIT_WIDTH * CLOCK_DIGIT_HEIGHT + CLOCK_COLON_WIDTH * CLOCK_COLON_HEIGHT;
+
+    if (clockAtlas565 == NULL && clockAtlas2bpp == NULL)
+    {
+        if (psramFound())
         {
-            previousArray[i] = -1;
+            clockAtlas565 = (uint16_t *)ps_malloc(atlasPixels * sizeof(uint16_t)); // 80 KB
+        }
+        if (clockAtlas565 == NULL)
+        {
+            clockAtlas2bpp = (uint8_t *)malloc((atlasPixels + 3) / 4); // 10 KB
+            clockTileBuffer = (uint16_t *)malloc(CLOCK_DIGIT_WIDTH * CLOCK_DIGIT_HEIGHT * sizeof(uint16_t));
+            if (clockAtlas2bpp == NULL || clockTileBuffer == NULL)
+            {
+                free(clockAtlas2bpp);
+                free(clockTileBuffer);
+                clockAtlas2bpp = NULL;
+                clockTileBuffer = NULL;
+                return false;
+            }
         }
-        refreshBecauseReturningFromOtherPage = false;
     }
-    static bool colonVisible = true;     // Tracks colon visibility
-                                         // Define the TFT_MIDGREY color as a local constant
-    const uint16_t TFT_MIDGREY = 0x39a7; // Darker grey https://rgbcolorpicker.com/565
-    // uint16_t TFT_MIDGREY = TFT_DARKGREY;
-    int gap = 68;
-    int gap2 = 20;
-    int xCoordinates[6] = {xOffset, xOffset + gap, xOffset + 2 * gap + gap2, xOffset + 3 * gap + gap2, xOffset + 4 * gap + 2 * gap2, xOffset + 5 * gap + 2 * gap2};
-
-    // Set the custom font
-    tft.setFreeFont(&HB9IIU7segFonts);
 
-    // Toggle colon visibility every second
-    if (unixtime % 1 == 0)
+    // Each glyph is composed in a sprite once, then copied (PSRAM) or packed (2 bpp) into the atlas
+    TFT_eSprite glyphSprite = TFT_eSprite(&tft);
+    if (glyphSprite.createSprite(CLOCK_DIGIT_WIDTH, CLOCK_DIGIT_HEIGHT) == NULL)
     {
-        colonVisible = !colonVisible;
+        return false;
     }
-
+    glyphSprite.setFreeFont(&HB9IIU7segFonts);
+    for (int glyph = 0; glyph <= CLOCK_COLON_GLYPH; glyph++)
+    {
+        int w, h, top;
+        size_t offset = clockGlyphCell(glyph, w, h, top);
+        glyphSprite.fillSprite(TFT_BLACK);
+        glyphSprite.setTextColor(textColor);
+        glyphSprite.setCursor(0, -top);
+        if (glyph == CLOCK_COLON_GLYPH)
+        {
+            glyphSprite.print(":");
+        }
+        else
+        {
+            glyphSprite.print(glyph);
+            if (mappedChars[glyph] != 'H')
+            {
+                glyphSprite.setTextColor(CLOCK_GHOST_COLOR);
+                glyphSprite.setCursor(0, -top);
+                glyphSprite.print(mappedChars[glyph]);
+            }
+        }
+
+        for (int y = 0; y < h; y++)
+        {
+            for (int x = 0; x < w; x++, offset++)
+            {
+                uint16_t color = glyphSprite.readPixel(x, y);
+                if (clockAtlas565 != NULL)
+                {
+                    clockAtlas565[offset] = (color >> 8) | (color << 8); // Display byte order, pushed as is
+                }
+                else
+                {
+                    uint8_t code = color == textColor ? 1 : (color == CLOCK_GHOST_COLOR ? 2 : 0);
+                    int shift = (offset & 3) * 2;
+                    clockAtlas2bpp[offset >> 2] = (clockAtlas2bpp[offset >> 2] & ~(3 << shift)) | (code << shift);
+                }
+            }
+        }
+    }
+    glyphSprite.deleteSprite();
+
+    clockAtlasColor = textColor;
+    clockAtlasReady = true;
+    Serial.printf("Clock glyph atlas: %s\n", clockAtlas565 != NULL ? "RGB565 in PSRAM" : "2 bpp");
+    return true;
+}
+void pushClockGlyph(int glyph, int x, int baseline)
+{
+    // One pushImage of the pre-composed tile, the ghost segments are part of it
+    int w, h, top;
+    size_t offset = clockGlyphCell(glyph, w, h, top);
+    if (clockAtlas565 != NULL)
+    {
+        tft.pushImage(x, baseline + top, w, h, clockAtlas565 + offset);
+        return;
+    }
+
+    const uint16_t palette[4] = {TFT_BLACK, (uint16_t)((clockAtlasColor >> 8) | (clockAtlasColor << 8)),
+                                 (uint16_t)((CLOCK_GHOST_COLOR >> 8) | (CLOCK_GHOST_COLOR << 8)), TFT_BLACK};
+    for (int i = 0; i < w * h; i++, offset++)
+    {
+        clockTileBuffer[i] = palette[(clockAtlas2bpp[offset >> 2] >> ((offset & 3) * 2)) & 3];
+    }
+    tft.pushImage(x, baseline + top, w, h, clockTileBuffer);
+}
+void display7segmentClock(int xOffset, int yOffset, uint16_t textColor, bool refreshBecauseReturningFromOtherPage)
+{
+    // Static variables to track previous state and colon visibility
+    static int previousArray[6] = {-1, -1, -1, -1, -1, -1}; // Initialize previous digit array
+    if (refreshBecauseReturningFromOtherPage == true)
+    {
+        for (int i = 0; i < 6; i++)
+        {
+            previousArray[i] = -1;
+        }
+        refreshBecauseReturningFromOtherPage = false;
+    }
+    static bool colonVisible = true;     // Tracks colon visibility
+                                         // Define the TFT_MIDGREY color as a local constant
+    const uint16_t TFT_MIDGREY = CLOCK_GHOST_COLOR;
+    static bool atlasFailed = false;     // Not enough memory, keep rasterising the font
+    if ((!clockAtlasReady || clockAtlasColor != textColor) && !atlasFailed)
+    {
+        atlasFailed = !buildClockAtlas(textColor);
+        for (int i = 0; i < 6; i++)
+        {
+            previousArray[i] = -1;
+        }
+    }
+    bool useAtlas = clockAtlasReady && clockAtlasColor == textColor;
+    // uint16_t TFT_MIDGREY = TFT_DARKGREY;
+    int gap = 68;
+    int gap2 = 20;
+    int xCoordinates[6] = {xOffset, xOffset + gap, xOffset + 2 * gap + gap2, xOffset + 3 * gap + gap2, xOffset + 4 * gap + 2 * gap2, xOffset + 5 * gap + 2 * gap2};
+
+    // Set the custom font
+    tft.setFreeFont(&HB9IIU7segFonts);
+
+    // Toggle colon visibility every second
+    if (unixtime % 1 == 0)
+    {
+        colonVisible = !colonVisible;
+    }
+
     // Display or hide colons based on colonVisible
-    uint16_t colonColor = colonVisible ? textColor : TFT_BLACK;
-    tft.setTextColor(colonColor, TFT_BLACK);
-    tft.setCursor(xCoordinates[2] - 24, yOffset);
-    tft.print(":");
-    tft.setCursor(xCoordinates[4] - 24, yOffset);
-    tft.print(":");
+    if (useAtlas)
+    {
+        for (int i = 2; i <= 4; i += 2)
+        {
+            if (colonVisible)
+            {
+                pushClockGlyph(CLOCK_COLON_GLYPH, xCoordinates[i] - 24, yOffset);
+            }
+            else
+            {
+                tft.fillRect(xCoordinates[i] - 24, yOffset + CLOCK_COLON_TOP, CLOCK_COLON_WIDTH, CLOCK_COLON_HEIGHT, TFT_BLACK);
+            }
+        }
+    }
+    else
+    {
+        uint16_t colonColor = colonVisible ? textColor : TFT_BLACK;
+        tft.setTextColor(colonColor, TFT_BLACK);
+        tft.setCursor(xCoordinates[2] - 24, yOffset);
+        tft.print(":");
+        tft.setCursor(xCoordinates[4] - 24, yOffset);
+        tft.print(":");
+    }
 
     // Calculate hours, minutes, and seconds
     unsigned long locatime = unixtime + totalTimeOffset;
@@ -1500,7 +2145,12 @@ void display7segmentClock(int xOffset, int yOffset, uint16_t textColor, bool ref
     // Update only changed digits
     for (int i = 0; i < 6; i++)
     {
-        if (timeArray[i] != previousArray[i])
+        if (timeArray[i] != previousArray[i] && useAtlas)
+        {
+            // Tile with the digit and its ghost segments, replaces the previous one without erasing
+            pushClockGlyph(timeArray[i], xCoordinates[i], yOffset);
+        }
+        else if (timeArray[i] != previousArray[i])
         {
             // Clear the previous digit
             tft.setTextColor(TFT_BLACK, TFT_BLACK);
@@ -1535,7 +2185,7 @@ void displayDistance(int number, int x, int y, uint16_t color, bool refreshBecau
     tft.setTextSize(1);
     tft.setTextFont(4);
 
-    static char previousOutput[7] = "      ";  // Previous state (6 characters + null terminator) 12'456
+    static WidgetField valueField;             // Value rectangle, pushed by pushWidgetFields()
     static uint16_t previousColor = TFT_GREEN; // Track the last color used
     static bool isInitiated = false;           // Track initialization of static elements
     char output[7] = "      ";                 // Current output (6 characters + null terminator)
@@ -1591,34 +2241,12 @@ void displayDistance(int number, int x, int y, uint16_t color, bool refreshBecau
         tft.setTextColor(color, TFT_BLACK);
         tft.drawString("km", xPos[5] + 24, y);
         tft.drawString("Distance:", x, y);
+        placeWidgetField(valueField, xPos, 6, y, 4, -1);
         isInitiated = true;
     }
 
-    // Update only changed characters or redraw all if refreshBecauseReturningFromOtherPage is triggered
-    for (int i = 0; i < 6; i++)
-    { // Loop through each character of the formatted number
-        // Serial.print(output[i]);
-        // Serial.print(" ");
-        if (output[i] != previousOutput[i] || refreshBecauseReturningFromOtherPage)
-        {
-            // Print the previous character in black to erase it
-            if (previousOutput[i] != ' ')
-            {
-                tft.setTextColor(TFT_BLACK, TFT_BLACK);
-                tft.drawChar(previousOutput[i], xPos[i], y);
-            }
-
-            // Draw the new character
-            if (output[i] != ' ')
-            {
-                tft.setTextColor(color, TFT_BLACK);
-                tft.drawChar(output[i], xPos[i], y);
-            }
-
-            // Update previous state
-            previousOutput[i] = output[i];
-        }
-    }
+    // Only marks the value dirty, it is rendered and pushed in one burst by pushWidgetFields()
+    setWidgetField(valueField, output, color, refreshBecauseReturningFromOtherPage);
     Serial.println();
 }
 void displayOrbitNumber(int number, int x, int y, uint16_t color, bool refreshBecauseReturningFromOtherPage)
@@ -1626,7 +2254,7 @@ void displayOrbitNumber(int number, int x, int y, uint16_t color, bool refreshBe
     tft.setTextSize(1);
     tft.setTextFont(4);
 
-    static char previousOutput[7] = "      ";  // Previous state (6 characters + null terminator) 12'456
+    static WidgetField valueField;             // Value rectangle, pushed by pushWidgetFields()
     static uint16_t previousColor = TFT_GREEN; // Track the last color used
     static bool isInitiated = false;           // Track initialization of static elements
     char output[7] = "      ";                 // Current output (6 characters + null terminator)
@@ -1681,34 +2309,12 @@ void displayOrbitNumber(int number, int x, int y, uint16_t color, bool refreshBe
     {
         tft.setTextColor(color, TFT_BLACK);
         tft.drawString("Orbit #:", x, y);
+        placeWidgetField(valueField, xPos, 6, y, 4, -1);
         isInitiated = true;
     }
 
-    // Update only changed characters or redraw all if refreshBecauseReturningFromOtherPage is triggered
-    for (int i = 0; i < 6; i++)
-    { // Loop through each character of the formatted number
-        // Serial.print(output[i]);
-        // Serial.print(" ");
-        if (output[i] != previousOutput[i] || refreshBecauseReturningFromOtherPage)
-        {
-            // Print the previous character in black to erase it
-            if (previousOutput[i] != ' ')
-            {
-                tft.setTextColor(TFT_BLACK, TFT_BLACK);
-                tft.drawChar(previousOutput[i], xPos[i], y);
-            }
-
-            // Draw the new character
-            if (output[i] != ' ')
-            {
-                tft.setTextColor(color, TFT_BLACK);
-                tft.drawChar(output[i], xPos[i], y);
-            }
-
-            // Update previous state
-            previousOutput[i] = output[i];
-        }
-    }
+    // Only marks the value dirty, it is rendered and pushed in one burst by pushWidgetFields()
+    setWidgetField(valueField, output, color, refreshBecauseReturningFromOtherPage);
     Serial.println();
 }
 void calculateNextPass()
@@ -1728,15 +2334,13 @@ void calculateNextPass()
     passMinutes = 0;
     passSeconds = 0;
 
-    passinfo overpass;
-
-    sat.initpredpoint(unixtime + 10 * 60, 0); // adding 10 minutes to ensure that next pass is not in the past (experimental)
+    // Current or next pass from the pass list (searches only when a pass has been consumed)
+    passPredictor.update(sat, unixtime, PASS_LIST_LENGTH);
+    const passinfo *nextPass = passPredictor.get(0);
 
-    // Find the next pass using up to 100 iterations
-    bool passFound = sat.nextpass(&overpass, 100);
-
-    if (passFound)
+    if (nextPass != NULL)
     {
+        const passinfo &overpass = *nextPass;
         int year, month, day, hour, minute;
         double second;
         bool daylightSaving = false;
@@ -1788,6 +2392,8 @@ void calculateNextPass()
         passMinutes = passDuration / 60;
         passSeconds = passDuration % 60;
 
+        updatePassTrack(); // Fit the pass ephemeris (only when the pass changed)
+
         /*
                 // Debug Output UTC
                 Serial.println();
@@ -1808,11 +2414,159 @@ void calculateNextPass()
                 Serial.println();
                 */
     }
+    else if (passPredictor.alwaysvisible())
+    {
+        Serial.println("Geostationary satellite, always above horizon.");
+    }
+    else if (passPredictor.nevervisible())
+    {
+        Serial.println("Geostationary satellite, never above horizon.");
+    }
     else
     {
         Serial.println("No pass found within specified parameters.");
     }
 }
+void updatePassTrack()
+{
+    // The ephemeris only depends on the pass, so it is fitted once and shared by all pages
+    if (passTrackForPass == nextPassStart && passEphemeris.covers(getJulianFromUnix(passTrackStart)))
+    {
+        return;
+    }
+    if (nextPassStart == 0 || nextPassEnd < nextPassStart)
+    {
+        passEphemeris.clear(); // No pass found
+        return;
+    }
+
+    passTrackStart = nextPassStart - PASS_TRACK_MARGIN;
+    passTrackEnd = nextPassEnd + PASS_TRACK_MARGIN;
+    passEphemeris.fit(sat, passTrackStart, passTrackEnd);
+    passTrackForPass = nextPassStart;
+}
+void setPassState(PassState newState)
+{
+    if (newState != passState)
+    {
+        Serial.printf("Pass state: %s -> %s\n", passStateNames[passState], passStateNames[newState]);
+        passState = newState;
+    }
+}
+void updatePassState()
+{
+    // A new TLE invalidates the cached pass
+    if (passStateEpoch != sat.satrec.jdsatepoch)
+    {
+        passStateEpoch = sat.satrec.jdsatepoch;
+        passRetryTime = 0;
+        setPassState(PASS_IDLE);
+    }
+
+    // The cached pass is in the past (clock correction), search again
+    if ((passState == PASS_UPCOMING || passState == PASS_IN_PASS) && unixtime > nextPassEnd + PASS_TRACK_MARGIN)
+    {
+        setPassState(PASS_IDLE);
+    }
+
+    switch (passState)
+    {
+    case PASS_IDLE:
+    case PASS_POST_PASS:
+        // After LOS wait until the satellite is below the horizon, otherwise the pass that just ended is found again
+        if (passState == PASS_POST_PASS && sat.satEl >= 0 && unixtime <= nextPassEnd + PASS_TRACK_MARGIN)
+        {
+            break;
+        }
+        if (passState == PASS_IDLE && unixtime < passRetryTime)
+        {
+            break;
+        }
+        {
+            uint32_t calculationStart = micros();
+            calculateNextPass();
+            passCalculationMicros += micros() - calculationStart;
+            passCalculations++;
+        }
+        if (nextPassEnd == 0)
+        {
+            passRetryTime = unixtime + PASS_RETRY_INTERVAL;
+            setPassState(PASS_IDLE);
+        }
+        else
+        {
+            setPassState(unixtime >= nextPassStart ? PASS_IN_PASS : PASS_UPCOMING);
+        }
+        break;
+
+    case PASS_UPCOMING:
+        if (unixtime >= nextPassStart)
+        {
+            setPassState(PASS_IN_PASS);
+        }
+        break;
+
+    case PASS_IN_PASS:
+        if (unixtime > nextPassEnd)
+        {
+            setPassState(PASS_POST_PASS);
+        }
+        break;
+    }
+}
+void reportLoopTiming()
+{
+    static unsigned long lastReport = 0;
+    if (unixtime - lastReport < LOOP_STATS_INTERVAL)
+    {
+        return;
+    }
+    if (lastReport != 0)
+    {
+        Serial.printf("Loop: %lu calls, %lu us busy per second, pass state %s, %lu pass calculations (%lu us)\n",
+                      loopCount, loopBusyMicros / (unixtime - lastReport), passStateNames[passState], passCalculations, passCalculationMicros);
+        Serial.printf("Heap: %u bytes free, %u lowest, %lu telemetry frames, %lu with heap allocations\n",
+                      ESP.getFreeHeap(), ESP.getMinFreeHeap(), telemetryFrames, telemetryHeapAllocations);
+    }
+    lastReport = unixtime;
+    loopCount = 0;
+    telemetryFrames = 0;
+    loopBusyMicros = 0;
+    passCalculations = 0;
+    passCalculationMicros = 0;
+}
+void updateSatPosition()
+{
+    // loop() runs many times per second, the position only changes with unixtime
+    static unsigned long lastUpdate = 0;
+    static unsigned long lastSunUpdate = 0;
+    if (unixtime == lastUpdate)
+    {
+        return;
+    }
+    lastUpdate = unixtime;
+
+    // During the pass, read the ephemeris so the main page shows the same track as the plot pages
+    if (passEphemeris.evaluate(unixtime))
+    {
+        sat.satAz = passEphemeris.satAz;
+        sat.satEl = passEphemeris.satEl;
+        sat.satDist = passEphemeris.satDist;
+        sat.satLat = passEphemeris.satLat;
+        sat.satLon = passEphemeris.satLon;
+        sat.satAlt = passEphemeris.satAlt;
+        sat.satJd = passEphemeris.satJd;
+        sat.satRangeRate = passEphemeris.satRangeRate;
+        if (unixtime - lastSunUpdate >= 60)
+        {
+            sat.findsat(unixtime, sunlight); // Sun position for the WebSocket clients, it barely moves during a pass
+            lastSunUpdate = unixtime;
+        }
+        return;
+    }
+    sat.findsat(unixtime);
+    lastSunUpdate = unixtime;
+}
 String formatTimeOnly(unsigned long epochTime, bool isLocal = false)
 {
     // Adjust the epoch time by adding timezone offset and DST offset if applicable
@@ -1957,255 +2711,361 @@ void beepAtTCA()
     ledcWriteTone(0, 0);    // Stop the tone
 }
 
-void displayAzElPlotPage()
+int refineTrackSegment(const TrackSample &a, const TrackSample &b, TrackProjection project, TrackSample *samples, int count, int maxSamples, int depth)
 {
-    const int stepsInSeconds = 1; // Step size in seconds
-    const int PLOT_X = 38;        // Left margin
-    const int PLOT_Y = 20;        // Top margin
-    const int PLOT_WIDTH = 410;   // Plot width
-    const int PLOT_HEIGHT = 240;  // Plot height
-    const int SCREEN_WIDTH = 480;
-    const int SCREEN_HEIGHT = 320;
-
-    // Clear Screen
-    tft.fillScreen(TFT_BLACK);
-
-    // Draw Axes
-    tft.drawRect(PLOT_X, PLOT_Y, PLOT_WIDTH, PLOT_HEIGHT, TFT_WHITE);
-
-    // Draw Azimuth Gridlines and Labels
-    int azGridInterval = 30;
-    for (int az = 0; az <= 360; az += azGridInterval)
+    // Appends the samples after a up to and including b. The segment is halved while the projection of its
+    // middle is further than TRACK_TOLERANCE_PIXELS from the linear interpolation of its ends.
+    // Every pending right half needs one slot, so refining stops before the buffer is exhausted.
+    if (b.t - a.t > TRACK_MIN_STEP && count + depth < maxSamples)
     {
-        int y = PLOT_Y + PLOT_HEIGHT - map(az, 0, 360, 0, PLOT_HEIGHT);
-        tft.drawLine(PLOT_X, y, PLOT_X + PLOT_WIDTH, y, TFT_DARKGREY);
-        if (az % 90 == 0) // Label key azimuths
+        TrackSample middle;
+        middle.t = a.t + (b.t - a.t) / 2;
+        if (project(middle.t, middle.v))
         {
-            tft.setFreeFont(&FreeMono9pt7b);
-            tft.setTextColor(TFT_GREENYELLOW, TFT_BLACK);
-            tft.setCursor(2, y - 5);
-            tft.printf("%d°", az);
+            float fraction = (float)(middle.t - a.t) / (b.t - a.t);
+            float deviation = 0;
+            for (int k = 0; k < 2; k++)
+            {
+                deviation = max(deviation, fabsf(middle.v[k] - (a.v[k] + (b.v[k] - a.v[k]) * fraction)));
+            }
+            if (deviation > TRACK_TOLERANCE_PIXELS)
+            {
+                count = refineTrackSegment(a, middle, project, samples, count, maxSamples, depth + 1);
+                return refineTrackSegment(middle, b, project, samples, count, maxSamples, depth);
+            }
         }
     }
-
-    // Draw Elevation Gridlines and Labels
-    int elGridInterval = 15;
-    for (int el = 0; el <= 90; el += elGridInterval)
+    if (count < maxSamples)
     {
-        int y = PLOT_Y + PLOT_HEIGHT - map(el, 0, 90, 0, PLOT_HEIGHT);
-        // Draw vertical gridline
-        tft.setTextColor(TFT_CYAN, TFT_BLACK);
-        tft.setCursor(PLOT_X + PLOT_WIDTH + 10, y - 5);
-        tft.printf("%d°", el);
+        samples[count++] = b;
     }
-
-    // Draw Time Gridlines and Labels
-    for (int i = 0; i <= 5; i++)
+    return count;
+}
+int sampleTrack(unsigned long start, unsigned long end, TrackProjection project, TrackSample *samples, int count, int maxSamples)
+{
+    // Appends samples from start to end to the first count samples: dense where the projected track bends,
+    // sparse where it is straight. Returns the new count, it stops early when the projection fails.
+    TrackSample a;
+    if (count > 0 && samples[count - 1].t == start)
     {
-        int x = PLOT_X + map(i, 0, 5, 0, PLOT_WIDTH);
-        unsigned long time = nextPassStart + i * (nextPassEnd - nextPassStart) / 5;
-        tft.drawLine(x, PLOT_Y, x, PLOT_Y + PLOT_HEIGHT, TFT_DARKGREY);
-
-        String timeStr = formatTimeOnly(time, true).substring(0, 5);
-        tft.setTextColor(TFT_WHITE, TFT_BLACK);
-        tft.setCursor(x - 28, PLOT_Y + PLOT_HEIGHT + 18);
-        tft.print(timeStr);
+        a = samples[count - 1]; // Continues the previous call
     }
-
-    // Start plotting Azimuth and Elevation
-    unsigned long currentTime = nextPassStart;
-    int lastAzX = -1, lastAzY = -1, lastElX = -1, lastElY = -1;
-    float lastAzimuth = -1;
-
-    while (currentTime <= nextPassEnd)
+    else
     {
-        sat.findsat(currentTime); // Update satellite position
-
-        // Calculate x position based on time
-        int x = PLOT_X + map(currentTime, nextPassStart, nextPassEnd, 0, PLOT_WIDTH);
-        int azY = PLOT_Y + PLOT_HEIGHT - map(sat.satAz, 0, 360, 0, PLOT_HEIGHT);
-        int elY = PLOT_Y + PLOT_HEIGHT - map(sat.satEl, 0, 90, 0, PLOT_HEIGHT);
-        /*
-        Serial.print("sat.satAz: ");
-        Serial.print(sat.satAz);
-        Serial.print("   sat.satEl: ");
-        Serial.println(sat.satEl);
-    */
-        if (lastAzX != -1)
-        {
-            // Handle azimuth wraparound
-            if (lastAzimuth != -1 && abs(sat.satAz - lastAzimuth) > 180)
-            {
-                if (sat.satAz > lastAzimuth)
-                {
-                    tft.drawLine(lastAzX, lastAzY, x, PLOT_Y + PLOT_HEIGHT - map(0, 0, 360, 0, PLOT_HEIGHT), TFT_CYAN);
-                    tft.drawLine(x, PLOT_Y + PLOT_HEIGHT - map(360, 0, 360, 0, PLOT_HEIGHT), x, azY, TFT_CYAN);
-                }
-                else
-                {
-                    tft.drawLine(lastAzX, lastAzY, x, PLOT_Y + PLOT_HEIGHT - map(360, 0, 360, 0, PLOT_HEIGHT), TFT_CYAN);
-                    tft.drawLine(x, PLOT_Y + PLOT_HEIGHT - map(0, 0, 360, 0, PLOT_HEIGHT), x, azY, TFT_CYAN);
-                }
-            }
-            else
-            {
-                tft.drawLine(lastAzX, lastAzY, x, azY, TFT_GREENYELLOW);
-            }
-
-            // Draw elevation line (no wraparound needed)
-            tft.drawLine(lastElX, lastElY, x, elY, TFT_CYAN);
+        a.t = start;
+        if (count >= maxSamples || !project(start, a.v))
+        {
+            return count;
         }
-
-        // Update for the next iteration
-        lastAzimuth = sat.satAz;
-        lastAzX = x;
-        lastAzY = azY;
-        lastElX = x;
-        lastElY = elY;
-
-        // Increment time by step size
-        currentTime += stepsInSeconds;
+        samples[count++] = a;
     }
-
-    // Display TCA Time
-    int tcaX = PLOT_X + map(nextPassCulminationTime, nextPassStart, nextPassEnd, 0, PLOT_WIDTH);
-    int tcaY = PLOT_Y + PLOT_HEIGHT - map(nextPassMaxTCA, 0, 90, 0, PLOT_HEIGHT);
-    String tcaTimeStr = formatTimeOnly(nextPassCulminationTime, true).substring(0, 5);
-    tft.setTextColor(TFT_GREEN, TFT_BLACK);
-    tft.setCursor(tcaX - 35, tcaY - 8);
-    tft.setFreeFont(&FreeMonoBold12pt7b);
-    tft.print(tcaTimeStr);
-    tft.fillCircle(tcaX, tcaY, 4, TFT_GREEN);
-
-    // Display Pass Duration
-    unsigned long duration = nextPassEnd - nextPassStart;
-    tft.setCursor(240 - tft.textWidth("Pass Duration: 10m 37s") / 2, 300);
-    tft.print("Pass Duration: ");
-    tft.print(duration / 60);
-    tft.print("m ");
-    tft.print(duration % 60);
-    tft.println("s");
-
-    // display current position if visible
-    // unixtime = timeClient.getEpochTime(); // Get the current UNIX time
-    sat.findsat(unixtime);
-    if (sat.satEl > 0)
+    for (int i = 1; i <= TRACK_SEED_SEGMENTS; i++)
     {
-        int x = PLOT_X + map(unixtime, nextPassStart, nextPassEnd, 0, PLOT_WIDTH);
-        int elY1 = PLOT_Y + PLOT_HEIGHT - map(0, 0, 90, 0, PLOT_HEIGHT);
-        int elY2 = PLOT_Y + PLOT_HEIGHT - map(sat.satEl, 0, 90, 0, PLOT_HEIGHT);
-        tft.drawLine(x - 1, elY1, x - 1, elY2, TFT_RED);
-        tft.drawLine(x, elY1, x, elY2, TFT_RED);
-        tft.drawLine(x + 1, elY1, x + 1, elY2, TFT_RED);
-        tft.fillCircle(x, elY2, 3, TFT_CYAN);
-        tft.drawCircle(x, elY2, 4, TFT_RED);
+        TrackSample b;
+        b.t = start + (end - start) * i / TRACK_SEED_SEGMENTS;
+        if (b.t == a.t)
+        {
+            continue;
+        }
+        if (!project(b.t, b.v))
+        {
+            break;
+        }
+        count = refineTrackSegment(a, b, project, samples, count, maxSamples, 1);
+        if (samples[count - 1].t != b.t)
+        {
+            break; // Buffer full
+        }
+        a = b;
     }
+    return count;
 }
-void displayPolarPlotPage()
+bool projectAzElPoint(unsigned long t, float v[2])
 {
+    // Pixel heights of the azimuth and elevation curves, time is the linear x axis
+    if (!passEphemeris.evaluate(t))
+    {
+        return false;
+    }
+    v[0] = passEphemeris.satAz * AZEL_PLOT_HEIGHT / 360.0;
+    v[1] = passEphemeris.satEl * AZEL_PLOT_HEIGHT / 90.0;
+    return true;
+}
+void buildAzElPlotTrack()
+{
+    // One point per pixel column, interpolated from adaptive samples and only rebuilt when the pass changes
+    updatePassTrack();
+    if (azElTrackForPass == nextPassStart && azElTrackPoints > 0)
+    {
+        return;
+    }
+    azElTrackPoints = 0;
+    azElTrackForPass = nextPassStart;
+    int count = sampleTrack(nextPassStart, nextPassEnd, projectAzElPoint, trackSamples, 0, TRACK_SAMPLES_MAX);
+    if (count < 2)
+    {
+        return;
+    }
+    unsigned long duration = nextPassEnd - nextPassStart;
+    int k = 0;
+    for (int column = 0; column <= AZEL_PLOT_WIDTH; column++)
+    {
+        unsigned long currentTime = nextPassStart + (unsigned long)column * duration / AZEL_PLOT_WIDTH;
+        if (currentTime > trackSamples[count - 1].t)
+        {
+            break; // Ephemeris ended early
+        }
+        while (k < count - 2 && trackSamples[k + 1].t < currentTime)
+        {
+            k++;
+        }
+        const TrackSample &a = trackSamples[k];
+        const TrackSample &b = trackSamples[k + 1];
+        float fraction = (float)(currentTime - a.t) / (b.t - a.t);
+        float azimuthY = a.v[0] + (b.v[0] - a.v[0]) * fraction;
+        float elevationY = a.v[1] + (b.v[1] - a.v[1]) * fraction;
+        if (fabsf(b.v[0] - a.v[0]) > AZEL_PLOT_HEIGHT / 2)
+        {
+            azimuthY = fraction < 0.5 ? a.v[0] : b.v[0]; // The azimuth wraps within this segment
+        }
+        azElTrackAzY[column] = AZEL_PLOT_HEIGHT - (int)azimuthY;
+        azElTrackElY[column] = AZEL_PLOT_HEIGHT - (int)elevationY;
+
+        // Handle azimuth wraparound
+        azElTrackWrap[column] = 0;
+        if (column > 0 && abs(azElTrackAzY[column] - azElTrackAzY[column - 1]) > AZEL_PLOT_HEIGHT / 2)
+        {
+            azElTrackWrap[column] = azElTrackAzY[column] < azElTrackAzY[column - 1] ? 1 : -1;
+        }
+        azElTrackPoints = column + 1;
+    }
+}
+void drawAzElPlot(TFT_eSPI &canvas, int x0, int y0)
+{
+    // Draws the plot area with its origin at (x0, y0) of the canvas, which is either a band sprite or the TFT
+    int left = x0;
+    int frameTop = y0 + AZEL_PLOT_Y;
+
+    // Draw Axes
+    canvas.drawRect(left, frameTop, AZEL_PLOT_WIDTH, AZEL_PLOT_HEIGHT, TFT_WHITE);
+
+    // Draw Azimuth Gridlines
+    int azGridInterval = 30;
+    for (int az = 0; az <= 360; az += azGridInterval)
+    {
+        int y = frameTop + AZEL_PLOT_HEIGHT - map(az, 0, 360, 0, AZEL_PLOT_HEIGHT);
+        canvas.drawLine(left, y, left + AZEL_PLOT_WIDTH, y, TFT_DARKGREY);
+    }
+
+    // Draw Time Gridlines
+    for (int i = 0; i <= 5; i++)
+    {
+        int x = left + map(i, 0, 5, 0, AZEL_PLOT_WIDTH);
+        canvas.drawLine(x, frameTop, x, frameTop + AZEL_PLOT_HEIGHT, TFT_DARKGREY);
+    }
+
+    // Azimuth and Elevation from the cached track
+    int bottomY = frameTop + AZEL_PLOT_HEIGHT - map(0, 0, 360, 0, AZEL_PLOT_HEIGHT);
+    int topY = frameTop + AZEL_PLOT_HEIGHT - map(360, 0, 360, 0, AZEL_PLOT_HEIGHT);
+    for (int column = 1; column < azElTrackPoints; column++)
+    {
+        int lastX = left + column - 1;
+        int x = left + column;
+        int lastAzY = frameTop + azElTrackAzY[column - 1];
+        int azY = frameTop + azElTrackAzY[column];
+        if (azElTrackWrap[column] > 0)
+        {
+            canvas.drawLine(lastX, lastAzY, x, bottomY, TFT_CYAN);
+            canvas.drawLine(x, topY, x, azY, TFT_CYAN);
+        }
+        else if (azElTrackWrap[column] < 0)
+        {
+            canvas.drawLine(lastX, lastAzY, x, topY, TFT_CYAN);
+            canvas.drawLine(x, bottomY, x, azY, TFT_CYAN);
+        }
+        else
+        {
+            canvas.drawLine(lastX, lastAzY, x, azY, TFT_GREENYELLOW);
+        }
+
+        // Draw elevation line (no wraparound needed)
+        canvas.drawLine(lastX, frameTop + azElTrackElY[column - 1], x, frameTop + azElTrackElY[column], TFT_CYAN);
+    }
+
+    // Display TCA Time
+    int tcaX = left + map(nextPassCulminationTime, nextPassStart, nextPassEnd, 0, AZEL_PLOT_WIDTH);
+    int tcaY = frameTop + AZEL_PLOT_HEIGHT - map(nextPassMaxTCA, 0, 90, 0, AZEL_PLOT_HEIGHT);
+    String tcaTimeStr = formatTimeOnly(nextPassCulminationTime, true).substring(0, 5);
+    canvas.setTextColor(TFT_GREEN, TFT_BLACK);
+    canvas.setFreeFont(&FreeMonoBold12pt7b);
+    canvas.setCursor(tcaX - 35, tcaY - 8);
+    canvas.print(tcaTimeStr);
+    canvas.fillCircle(tcaX, tcaY, 4, TFT_GREEN);
+
+    // display current position if visible
+    // sat.satAz/satEl are kept current by updateSatPosition()
+    if (sat.satEl > 0)
+    {
+        int x = left + map(unixtime, nextPassStart, nextPassEnd, 0, AZEL_PLOT_WIDTH);
+        int elY1 = frameTop + AZEL_PLOT_HEIGHT - map(0, 0, 90, 0, AZEL_PLOT_HEIGHT);
+        int elY2 = frameTop + AZEL_PLOT_HEIGHT - map(sat.satEl, 0, 90, 0, AZEL_PLOT_HEIGHT);
+        canvas.drawLine(x - 1, elY1, x - 1, elY2, TFT_RED);
+        canvas.drawLine(x, elY1, x, elY2, TFT_RED);
+        canvas.drawLine(x + 1, elY1, x + 1, elY2, TFT_RED);
+        canvas.fillCircle(x, elY2, 3, TFT_CYAN);
+        canvas.drawCircle(x, elY2, 4, TFT_RED);
+    }
+}
+void pushAzElPlot()
+{
+    // The plot region is composited band by band into one sprite, and each band is pushed with pushImage().
+    // No DMA: with ILI9488_DRIVER TFT_eSPI sends 18-bit pixels and has no DMA path, pushImage() converts the band.
+    static bool bandCreated = false;
+    if (!bandCreated)
+    {
+        bandCreated = azElBand.createSprite(AZEL_REGION_WIDTH, AZEL_BAND_ROWS) != NULL;
+        if (!bandCreated)
+        {
+            Serial.println("Az/El plot: not enough memory for the band buffer, drawing directly");
+        }
+    }
+    uint32_t start = micros();
+    if (!bandCreated)
+    {
+        tft.fillRect(AZEL_PLOT_X, 0, AZEL_REGION_WIDTH, AZEL_REGION_HEIGHT, TFT_BLACK);
+        drawAzElPlot(tft, AZEL_PLOT_X, 0);
+    }
+    else
+    {
+        tft.startWrite();
+        for (int bandY = 0; bandY < AZEL_REGION_HEIGHT; bandY += AZEL_BAND_ROWS)
+        {
+            int rows = min(AZEL_BAND_ROWS, AZEL_REGION_HEIGHT - bandY);
+            azElBand.fillSprite(TFT_BLACK);
+            drawAzElPlot(azElBand, 0, -bandY);
+            // The last band is shorter, pushSprite() would overwrite the labels below the region
+            tft.pushImage(AZEL_PLOT_X, bandY, AZEL_REGION_WIDTH, rows, (uint16_t *)azElBand.getPointer());
+        }
+        tft.endWrite();
+    }
+    Serial.printf("Az/El plot: refreshed in %lu us\n", (unsigned long)(micros() - start));
+}
+void displayAzElPlotPage(bool fullRedraw)
+{
+    buildAzElPlotTrack();
+    if (azElLabelsForPass != nextPassStart)
+    {
+        fullRedraw = true; // New pass, the time labels change
+    }
+
+    // Labels around the plot are static, they are only drawn when the page is entered or the pass changes
+    if (fullRedraw)
+    {
+        // Clear Screen
+        tft.fillScreen(TFT_BLACK);
+
+        // Azimuth Labels
+        tft.setFreeFont(&FreeMono9pt7b);
+        tft.setTextColor(TFT_GREENYELLOW, TFT_BLACK);
+        for (int az = 0; az <= 360; az += 90)
+        {
+            int y = AZEL_PLOT_Y + AZEL_PLOT_HEIGHT - map(az, 0, 360, 0, AZEL_PLOT_HEIGHT);
+            tft.setCursor(2, y - 5);
+            tft.printf("%d°", az);
+        }
+
+        // Elevation Labels
+        int elGridInterval = 15;
+        tft.setTextColor(TFT_CYAN, TFT_BLACK);
+        for (int el = 0; el <= 90; el += elGridInterval)
+        {
+            int y = AZEL_PLOT_Y + AZEL_PLOT_HEIGHT - map(el, 0, 90, 0, AZEL_PLOT_HEIGHT);
+            tft.setCursor(AZEL_PLOT_X + AZEL_PLOT_WIDTH + 10, y - 5);
+            tft.printf("%d°", el);
+        }
+
+        // Time Labels
+        tft.setTextColor(TFT_WHITE, TFT_BLACK);
+        for (int i = 0; i <= 5; i++)
+        {
+            int x = AZEL_PLOT_X + map(i, 0, 5, 0, AZEL_PLOT_WIDTH);
+            unsigned long time = nextPassStart + i * (nextPassEnd - nextPassStart) / 5;
+            String timeStr = formatTimeOnly(time, true).substring(0, 5);
+            tft.setCursor(x - 28, AZEL_PLOT_Y + AZEL_PLOT_HEIGHT + 18);
+            tft.print(timeStr);
+        }
 
-    getOrbitNumber(nextPassStart);
-    // Clear the area to redraw
-    tft.fillScreen(TFT_BLACK);
-    // Display AOS on TFT screen
-    int margin = 5;
-    int newline = 8;
-    tft.setCursor(margin, 10);
-    tft.setTextColor(TFT_GOLD, TFT_BLACK);
-    tft.setTextFont(4);                            // Set the desired font
-    tft.print("ISS Orbit ");                       // Label for Orbit number
-    tft.println(formatWithSeparator(orbitNumber)); // Label for Orbit number
-    tft.setCursor(margin, tft.getCursorY() + 5);
-    tft.setTextColor(TFT_GREEN, TFT_BLACK);
-
-    tft.print("AOS  "); // Label for AOS
-
-    tft.setTextFont(2);                           // Set the desired font
-    tft.println(formatDate(nextPassStart, true)); // Prints just the date
-    tft.setCursor(margin, tft.getCursorY() + 8);  // Move to next line at x=5
-
-    tft.setTextFont(4);                               // Set the desired font
-    tft.setCursor(margin, tft.getCursorY());          // Move to next line at x=5
-    tft.println(formatTimeOnly(nextPassStart, true)); // Prints just the time
-
-    tft.setCursor(margin, tft.getCursorY());          // Move to next line at x=5
-    int azimuthInt = (int)(nextPassAOSAzimuth + 0.5); // Rounds to nearest integer
-    tft.print(azimuthInt);
-    tft.println(" deg.");
-    tft.setCursor(10, tft.getCursorY() + newline);
-
-    Serial.print("Azimuth at AOS: ");
-    Serial.print(nextPassAOSAzimuth);
-    Serial.println("°");
-
-    Serial.print("Max Elevation TCA: ");
-    Serial.print(nextPassMaxTCA);
-    Serial.println("° at time ");
-    Serial.println(formatTime(nextPassCulminationTime, true));
-    Serial.print("Azimuth at max elevation:");
-    Serial.print(culminationAzimuth);
-    Serial.println("°");
-
-    // Display TCA
-    tft.setTextFont(4); // Set the desired font
-    tft.setTextColor(TFT_YELLOW, TFT_BLACK);
-    tft.setCursor(margin, tft.getCursorY()); // Move to next line at x=5
-    tft.print("TCA ");                       // Label for TCA
-    tft.print(nextPassMaxTCA, 1);            // 1 specifies the number of decimal places
-    tft.println(" deg.");
-    // Set the desired font
-    tft.setCursor(margin, tft.getCursorY());                    // Move to next line at x=5
-    tft.println(formatTimeOnly(nextPassCulminationTime, true)); // Prints just the time
-
-    tft.setCursor(margin, tft.getCursorY());      // Move to next line at x=5
-    azimuthInt = (int)(culminationAzimuth + 0.5); // Rounds to nearest integer
-    tft.print(azimuthInt);
-    tft.println(" deg.");
-    tft.setCursor(10, tft.getCursorY() + newline);
-
-    // Display LOS
-    tft.setTextFont(4); // Set the desired font
-    tft.setTextColor(TFT_RED, TFT_BLACK);
-    tft.setCursor(margin, tft.getCursorY()); // Move to next line at x=5
-
-    tft.println("LOS"); // Label for TCA
-
-    tft.setTextFont(2);                             // Set the desired font
-    tft.setCursor(margin, tft.getCursorY());        // Move to next line at x=5
-    tft.setTextFont(4);                             // Set the desired font
-    tft.setCursor(margin, tft.getCursorY());        // Move to next line at x=5
-    tft.println(formatTimeOnly(nextPassEnd, true)); // Prints just the time
-
-    tft.setCursor(margin, tft.getCursorY());      // Move to next line at x=5
-    azimuthInt = (int)(nextPassLOSAzimuth + 0.5); // Rounds to nearest integer
-    tft.print(azimuthInt);
-    tft.println(" deg.");
-    tft.setTextColor(TFT_GOLD, TFT_BLACK);
-    tft.setCursor(margin, tft.getCursorY() + newline);
-    tft.print("Pass Duration: ");
-    unsigned long duration = nextPassEnd - nextPassStart;
-
-    tft.print(duration / 60);
-    tft.print(":");
-
-    tft.print(duration % 60);
-
-    Serial.print("Pass Duration: ");
-    Serial.print(duration / 60); // minutes
-    Serial.print(" min ");
-    Serial.print(duration % 60); // seconds
-    Serial.println(" sec");
-
-    Serial.print("LOS (End): ");
-    Serial.println(formatTime(nextPassEnd, true));
-    Serial.print("Azimuth at LOS: ");
-    Serial.print(nextPassLOSAzimuth);
-    Serial.println("°");
+        // Display Pass Duration
+        unsigned long duration = nextPassEnd - nextPassStart;
+        tft.setTextColor(TFT_GREEN, TFT_BLACK);
+        tft.setFreeFont(&FreeMonoBold12pt7b);
+        tft.setCursor(240 - tft.textWidth("Pass Duration: 10m 37s") / 2, 300);
+        tft.print("Pass Duration: ");
+        tft.print(duration / 60);
+        tft.print("m ");
+        tft.print(duration % 60);
+        tft.println("s");
+
+        azElLabelsForPass = nextPassStart;
+    }
 
-#define POLAR_CENTER_X 320 // Center of the polar chart
-#define POLAR_CENTER_Y 160 // Center of the polar chart
-#define POLAR_RADIUS 140   // Maximum radius for the outermost circle
+    // Plot area: grid, pass curve, TCA and current position in one bulk transfer
+    pushAzElPlot();
+}
+bool projectPolarPoint(unsigned long t, float v[2])
+{
+    // Screen position on the polar chart, clamped to the horizon circle
+    if (!passEphemeris.evaluate(t))
+    {
+        return false;
+    }
+    float radius = (90 - max(passEphemeris.satEl, 0.0)) * POLAR_RADIUS / 90;
+    float radianAzimuth = radians(passEphemeris.satAz);
+    v[0] = POLAR_CENTER_X + radius * sin(radianAzimuth);
+    v[1] = POLAR_CENTER_Y - radius * cos(radianAzimuth);
+    return true;
+}
+void buildPolarTrack()
+{
+    // Projected pass track from AOS to LOS with TCA as a sample, only rebuilt when the pass changes
+    updatePassTrack();
+    if (polarTrackForPass == nextPassStart && polarTrackPoints > 0)
+    {
+        return;
+    }
+    polarTrackPoints = 0;
+    polarTrackTCA = -1;
+    polarTrackForPass = nextPassStart;
+    int count = 0;
+    int tcaSample = -1;
+    if (nextPassCulminationTime > nextPassStart && nextPassCulminationTime < nextPassEnd)
+    {
+        count = sampleTrack(nextPassStart, nextPassCulminationTime, projectPolarPoint, trackSamples, count, TRACK_SAMPLES_MAX);
+        tcaSample = count - 1;
+    }
+    unsigned long resume = count > 0 ? nextPassCulminationTime : nextPassStart;
+    count = sampleTrack(resume, nextPassEnd, projectPolarPoint, trackSamples, count, TRACK_SAMPLES_MAX);
+    for (int i = 0; i < count; i++)
+    {
+        int16_t x = trackSamples[i].v[0];
+        int16_t y = trackSamples[i].v[1];
 
+        // Samples near TCA often land on the same pixel
+        int last = polarTrackPoints - 1;
+        if (last < 0 || polarTrackX[last] != x || polarTrackY[last] != y)
+        {
+            polarTrackX[polarTrackPoints] = x;
+            polarTrackY[polarTrackPoints] = y;
+            polarTrackPoints++;
+        }
+        if (i == tcaSample)
+        {
+            polarTrackTCA = polarTrackPoints - 1;
+        }
+    }
+}
+void drawPolarChart()
+{
     // Elevations to label and draw circles for
     int elevations[] = {0, 15, 30, 45, 60, 75};
 
@@ -2265,74 +3125,162 @@ void displayPolarPlotPage()
     tft.drawCentreString("W", POLAR_CENTER_X - POLAR_RADIUS - 10, POLAR_CENTER_Y, 2);
 
     // Plot the satellite pass path with color dots for AOS, max elevation, and LOS
-    int lastX = -1, lastY = -1;
-    // Time step for pass prediction
-    int timeStep = 1;
-    bool AOSdrawm = false;
+    for (int i = 1; i < polarTrackPoints; i++)
+    {
+        tft.drawLine(polarTrackX[i - 1], polarTrackY[i - 1], polarTrackX[i], polarTrackY[i], TFT_GOLD); // Path
+    }
+    if (polarTrackPoints > 0)
+    {
+        tft.fillCircle(polarTrackX[0], polarTrackY[0], 3, TFT_GREEN); // Green dot for AOS
+    }
+    if (polarTrackTCA >= 0)
+    {
+        tft.fillCircle(polarTrackX[polarTrackTCA], polarTrackY[polarTrackTCA], 3, TFT_YELLOW); // Yellow dot for max elevation
+    }
+    if (polarTrackPoints > 0)
+    {
+        tft.fillCircle(polarTrackX[polarTrackPoints - 1], polarTrackY[polarTrackPoints - 1], 3, TFT_RED); // Red dot for LOS
+    }
+}
+void movePolarMarker()
+{
+    // Only the current position marker and its radial line change between refreshes: when the marker moves
+    // they are painted black and the chart is drawn again, clipped to the rectangle they covered
+    bool visible = sat.satEl > 0; // kept current by updateSatPosition()
     int x = 0;
     int y = 0;
-    for (unsigned long t = nextPassStart - 30; t <= nextPassEnd + 30; t += timeStep) // just adding some  second 'margin'
+    if (visible)
     {
-        sat.findsat(t);
-        float azimuth = sat.satAz;
-        float elevation = sat.satEl;
-        /*
-        Serial.print("azimuth = ");
-        Serial.print(azimuth);
-        Serial.print("  elevation = ");
-        Serial.println(elevation);
-        */
-        // Serial.printf("Time: %lu | Azimuth: %.2f | Elevation: %.2f\n", t, azimuth, elevation);
-
-        if (elevation >= 0)
-        {
-            int radius = map(90 - elevation, 0, 90, 0, POLAR_RADIUS);
-            float radianAzimuth = radians(azimuth);
-            x = POLAR_CENTER_X + radius * sin(radianAzimuth);
-            y = POLAR_CENTER_Y - radius * cos(radianAzimuth);
-
-            // Serial.printf("Plotted Point -> x: %d, y: %d\n", x, y);
-
-            if (elevation > 0 && AOSdrawm == false)
-            {
-                tft.fillCircle(x, y, 3, TFT_GREEN); // Green dot for AOS
-                AOSdrawm = true;
-            }
-            if (t == nextPassCulminationTime)
-            {
-                tft.fillCircle(x, y, 3, TFT_YELLOW); // Yellow dot for max elevation
-                                                     // Serial.println("Plotted TCA (Yellow)");
-            }
-
-            if (lastX != -1 && lastY != -1)
-            {
-                tft.drawLine(lastX, lastY, x, y, TFT_GOLD); // Path
-                                                            // Serial.println("Drew Line Segment");
-            }
-            lastX = x;
-            lastY = y;
-        }
+        int radius = map(90 - sat.satEl, 0, 90, 0, POLAR_RADIUS);
+        float radianAzimuth = radians(sat.satAz);
+        x = POLAR_CENTER_X + radius * sin(radianAzimuth);
+        y = POLAR_CENTER_Y - radius * cos(radianAzimuth);
+    }
+    if (polarMarkerShown && visible && x == polarMarkerX && y == polarMarkerY)
+    {
+        return; // Still on the same pixel
     }
-    tft.fillCircle(x, y, 3, TFT_RED); // Red dot for LOS
-
-    // IF VISIBLE
-    // display current position if visible
-    sat.findsat(unixtime);
 
-    if (sat.satEl > 0)
+    const int half = POLAR_MARKER_SIZE / 2;
+    if (polarMarkerShown)
+    {
+        int left = min(POLAR_CENTER_X, polarMarkerX - half);
+        int top = min(POLAR_CENTER_Y, polarMarkerY - half);
+        int right = max(POLAR_CENTER_X, polarMarkerX + half);
+        int bottom = max(POLAR_CENTER_Y, polarMarkerY + half);
+        tft.startWrite();
+        tft.drawLine(POLAR_CENTER_X, POLAR_CENTER_Y, polarMarkerX, polarMarkerY, TFT_BLACK);
+        tft.fillRect(polarMarkerX - half, polarMarkerY - half, POLAR_MARKER_SIZE, POLAR_MARKER_SIZE, TFT_BLACK);
+        tft.setViewport(left, top, right - left + 1, bottom - top + 1, false); // Screen coordinates, clipped
+        drawPolarChart();
+        tft.resetViewport();
+        tft.endWrite();
+        polarMarkerShown = false;
+    }
+    if (!visible)
     {
-        float azimuth = sat.satAz;
-        float elevation = sat.satEl;
-        int radius = map(90 - elevation, 0, 90, 0, POLAR_RADIUS);
-        float radianAzimuth = radians(azimuth);
+        return;
+    }
 
-        x = POLAR_CENTER_X + radius * sin(radianAzimuth);
-        y = POLAR_CENTER_Y - radius * cos(radianAzimuth);
+    tft.startWrite();
+    tft.fillCircle(x, y, 3, TFT_CYAN);
+    tft.drawCircle(x, y, 4, TFT_RED);
+    tft.drawLine(POLAR_CENTER_X, POLAR_CENTER_Y, x, y, TFT_CYAN);
+    tft.endWrite();
+    polarMarkerX = x;
+    polarMarkerY = y;
+    polarMarkerShown = true;
+}
+void displayPolarPlotPage(bool fullRedraw)
+{
+    buildPolarTrack();
+    if (polarChartForPass != nextPassStart)
+    {
+        fullRedraw = true; // New pass, the track and the pass details change
+    }
 
-        tft.fillCircle(x, y, 3, TFT_CYAN);
-        tft.drawCircle(x, y, 4, TFT_RED);
-        tft.drawLine(POLAR_CENTER_X, POLAR_CENTER_Y, x, y, TFT_CYAN);
+    // Pass details and chart are static, they are only drawn when the page is entered or the pass changes
+    if (fullRedraw)
+    {
+        getOrbitNumber(nextPassStart);
+        // Clear the area to redraw
+        tft.fillScreen(TFT_BLACK);
+        // Display AOS on TFT screen
+        int margin = 5;
+        int newline = 8;
+        tft.setCursor(margin, 10);
+        tft.setTextColor(TFT_GOLD, TFT_BLACK);
+        tft.setTextFont(4);                            // Set the desired font
+        tft.print("ISS Orbit ");                       // Label for Orbit number
+        tft.println(formatWithSeparator(orbitNumber)); // Label for Orbit number
+        tft.setCursor(margin, tft.getCursorY() + 5);
+        tft.setTextColor(TFT_GREEN, TFT_BLACK);
+
+        tft.print("AOS  "); // Label for AOS
+
+        tft.setTextFont(2);                           // Set the desired font
+        tft.println(formatDate(nextPassStart, true)); // Prints just the date
+        tft.setCursor(margin, tft.getCursorY() + 8);  // Move to next line at x=5
+
+        tft.setTextFont(4);                               // Set the desired font
+        tft.setCursor(margin, tft.getCursorY());          // Move to next line at x=5
+        tft.println(formatTimeOnly(nextPassStart, true)); // Prints just the time
+
+        tft.setCursor(margin, tft.getCursorY());          // Move to next line at x=5
+        int azimuthInt = (int)(nextPassAOSAzimuth + 0.5); // Rounds to nearest integer
+        tft.print(azimuthInt);
+        tft.println(" deg.");
+        tft.setCursor(10, tft.getCursorY() + newline);
+
+        // Display TCA
+        tft.setTextFont(4); // Set the desired font
+        tft.setTextColor(TFT_YELLOW, TFT_BLACK);
+        tft.setCursor(margin, tft.getCursorY()); // Move to next line at x=5
+        tft.print("TCA ");                       // Label for TCA
+        tft.print(nextPassMaxTCA, 1);            // 1 specifies the number of decimal places
+        tft.println(" deg.");
+        // Set the desired font
+        tft.setCursor(margin, tft.getCursorY());                    // Move to next line at x=5
+        tft.println(formatTimeOnly(nextPassCulminationTime, true)); // Prints just the time
+
+        tft.setCursor(margin, tft.getCursorY());      // Move to next line at x=5
+        azimuthInt = (int)(culminationAzimuth + 0.5); // Rounds to nearest integer
+        tft.print(azimuthInt);
+        tft.println(" deg.");
+        tft.setCursor(10, tft.getCursorY() + newline);
+
+        // Display LOS
+        tft.setTextFont(4); // Set the desired font
+        tft.setTextColor(TFT_RED, TFT_BLACK);
+        tft.setCursor(margin, tft.getCursorY()); // Move to next line at x=5
+
+        tft.println("LOS"); // Label for TCA
+
+        tft.setTextFont(2);                             // Set the desired font
+        tft.setCursor(margin, tft.getCursorY());        // Move to next line at x=5
+        tft.setTextFont(4);                             // Set the desired font
+        tft.setCursor(margin, tft.getCursorY());        // Move to next line at x=5
+        tft.println(formatTimeOnly(nextPassEnd, true)); // Prints just the time
+
+        tft.setCursor(margin, tft.getCursorY());      // Move to next line at x=5
+        azimuthInt = (int)(nextPassLOSAzimuth + 0.5); // Rounds to nearest integer
+        tft.print(azimuthInt);
+        tft.println(" deg.");
+        tft.setTextColor(TFT_GOLD, TFT_BLACK);
+        tft.setCursor(margin, tft.getCursorY() + newline);
+        tft.print("Pass Duration: ");
+        unsigned long duration = nextPassEnd - nextPassStart;
+
+        tft.print(duration / 60);
+        tft.print(":");
+
+        tft.print(duration % 60);
+
+        drawPolarChart();
+        polarMarkerShown = false; // Cleared with the screen
+        polarChartForPass = nextPassStart;
     }
+    movePolarMarker();
 }
 void retrieveTLEelementsForSatellite(int catalogNumber)
 {
@@ -2395,9 +3343,8 @@ void retrieveTLEelementsForSatellite(int catalogNumber)
 }
 void displayTableNext10Passes()
 {
-    passinfo overpass;
-    // Initialize prediction start point
-    sat.initpredpoint(unixtime + 10 * 60, 0); // adding 10 minutes to ensure that next pass is not in the past (experimental)
+    // Passes come from the pass list, which is only extended when passes have been consumed
+    int passCount = passPredictor.update(sat, unixtime, PASS_LIST_LENGTH);
 
     Serial.println("Next 10 Passes:");
     Serial.println("--------------------");
@@ -2429,11 +3376,11 @@ void displayTableNext10Passes()
     long adjustedTimezoneOffset = totalTimeOffset; // Correctly adjust for DST and timezone offset
 
     // Iterate through the next 10 passes
-    for (int i = 1; i <= 12; i++) // Loop for next 12 passes (as per your original code)
+    for (int i = 1; i <= PASS_LIST_LENGTH; i++) // Loop for next 12 passes (as per your original code)
     {
-        bool passFound = sat.nextpass(&overpass, 100);
-        if (passFound)
+        if (i <= passCount)
         {
+            const passinfo &overpass = *passPredictor.get(i - 1);
             // Prepare persistent struct tm objects for AOS, TCA, and LOS
             struct tm aosTm = {0}, tcaTm = {0}, losTm = {0};
 
@@ -2520,139 +3467,371 @@ void displayTableNext10Passes()
         }
     }
 }
-void displayMapWithMultiPasses()
+bool mapBackgroundRow(int x, int y, int w, uint16_t *line)
 {
-    // Constants for map scaling and placement
-    const int mapWidth = 480;  // Width of the map
-    const int mapHeight = 290; // Height of the map
-    const int mapOffsetY = 30; // Y-offset for the map (black banner)
-    const int timeStep = 20;   // Time step for plotting points
-
-    // Clear the screen and display the map image
-    tft.fillScreen(TFT_BLACK);
-    displayEquirectangularWorlsMap();
-
-    // STEP 1: Get satellite position and draw the footprint
-    sat.findsat(unixtime);
-    float startLat = sat.satLat; // Satellite latitude
-    float startLon = sat.satLon; // Satellite longitude
-    float satAlt = sat.satAlt;   // Satellite altitude
-
-    // Calculate footprint radius in kilometers
-    float earthRadius = 6371.0; // Earth's radius in kilometers
-    float footprintRadiusKm = earthRadius * acos(earthRadius / (earthRadius + satAlt));
-
-    // Debug: Print footprint radius
-    Serial.print("Footprint radius (km): ");
-    Serial.println(footprintRadiusKm);
-
-    // Draw the footprint as an ellipse
-    for (int angle = 0; angle < 360; angle++)
+    // Map pixels in display byte order, from the PSRAM cache or decoded again from worldMapRle.
+    // The panel is not read back: its MISO line is shared with the touch controller.
+    if (worldMapCacheReady)
     {
-        float rad = angle * DEG_TO_RAD; // Convert angle to radians
-
-        // Calculate latitude and longitude for each point on the footprint
-        float deltaLat = footprintRadiusKm * cos(rad) / 111.0;                                // Latitude adjustment (1° ≈ 111 km)
-        float deltaLon = footprintRadiusKm * sin(rad) / (111.0 * cos(startLat * DEG_TO_RAD)); // Longitude adjustment
-
-        float footprintLat = startLat + deltaLat; // New latitude for the footprint point
-        float footprintLon = startLon + deltaLon; // New longitude for the footprint point
-
-        // Longitude wrapping to keep within -180° to 180°
-        if (footprintLon > 180.0)
-            footprintLon -= 360.0;
-        if (footprintLon < -180.0)
-            footprintLon += 360.0;
-
-        // Map latitude and longitude to screen coordinates
-        int x = map(footprintLon, -180, 180, 0, mapWidth);             // Longitude to X
-        int y = map(footprintLat, 90, -90, 0, mapHeight) + mapOffsetY; // Latitude to Y with offset
-
-        // Draw footprint point if within screen bounds
-        if (x >= 0 && x < mapWidth && y >= mapOffsetY && y < mapHeight + mapOffsetY)
+        memcpy(line, worldMapCache + y * WORLD_MAP_WIDTH + x, w * sizeof(uint16_t));
+        return true;
+    }
+#ifdef WORLD_MAP_RLE
+    if (worldMapRowsReady)
+    {
+        if (y != worldMapRowY)
         {
-            // tft.fillCircle(x, y, 1, TFT_GOLD);
-            tft.drawPixel(x, y, TFT_GOLD);
+            decodeRleRow(worldMapRle, worldMapRows[y], worldMapRow);
+            worldMapRowY = y;
         }
+        memcpy(line, worldMapRow + x, w * sizeof(uint16_t));
+        return true;
     }
-
-    // STEP 2: Plot the starting position
-    int startX = map(startLon, -180, 180, 0, mapWidth);             // Longitude to X-coordinate
-    int startY = map(startLat, 90, -90, 0, mapHeight) + mapOffsetY; // Latitude to Y-coordinate with offset
-
-    // Mark the starting position
-    tft.fillCircle(startX, startY, 3, TFT_YELLOW); // Starting point
-    tft.drawCircle(startX, startY, 4, TFT_RED);
-    tft.drawCircle(startX, startY, 5, TFT_RED);
-
-    // Debug: Print starting position
-    Serial.print("Starting Point (X, Y): ");
-    Serial.print(startX);
-    Serial.print(", ");
-    Serial.println(startY);
-
-    // STEP 3: Plot the satellite's path for three orbits
-    unixtime = timeClient.getEpochTime(); // Get the current UNIX timestamp
-
-    unsigned long t = unixtime;
-    int passageCount = 0;
-    bool hasLeftStartX = false;
-
-    while (passageCount < 3)
+#endif
+    return false;
+}
+uint16_t mapBackgroundPixel(int x, int y)
+{
+    uint16_t color = TFT_BLACK;
+    if (!mapBackgroundRow(x, y, 1, &color))
     {
-        sat.findsat(t);
-        float lat = sat.satLat;
-        float lon = sat.satLon;
-
-        // Map latitude and longitude to screen coordinates
-        int x = map(lon, -180, 180, 0, mapWidth);             // Longitude to X
-        int y = map(lat, 90, -90, 0, mapHeight) + mapOffsetY; // Latitude to Y with offset
-
-        // Choose color based on passage count
-        uint16_t color = (passageCount == 0) ? TFT_GREEN : (passageCount == 1) ? TFT_YELLOW
-                                                                               : TFT_RED;
-
-        // Draw the satellite's path
-        // tft.fillCircle(x, y, 1, color);
-        tft.drawPixel(x, y, color);
-
-        // Check if the satellite moved away from the starting X position
-        if (!hasLeftStartX && abs(x - startX) > 20)
+        mapOverlayComplete = false; // No map source, the next refresh redraws the map
+        return TFT_BLACK;
+    }
+    return (color >> 8) | (color << 8);
+}
+void plotMapPixel(int x, int y, uint16_t color)
+{
+    // drawPixel() that records the pixel beneath for restoreMapOverlay()
+    if (x < 0 || x >= WORLD_MAP_WIDTH || y < 0 || y >= WORLD_MAP_HEIGHT)
+    {
+        return;
+    }
+    if (mapOverlayPixels < MAP_OVERLAY_MAX)
+    {
+        MapOverlayPixel &pixel = mapOverlay[mapOverlayPixels++];
+        pixel.x = x;
+        pixel.y = y;
+        pixel.background = mapBackgroundPixel(x, y);
+    }
+    else
+    {
+        mapOverlayComplete = false; // Not restorable, the next refresh redraws the map
+    }
+    tft.drawPixel(x, y, color);
+}
+void restoreMapOverlay()
+{
+    // Puts back the pixels under the ground track, the marker and the footprint, in reverse drawing order
+    // so that overlapping overlays end up with the map beneath them
+    tft.startWrite();
+    for (int i = mapOverlayPixels - 1; i >= mapMarkerIndex; i--) // Ground track
+    {
+        tft.drawPixel(mapOverlay[i].x, mapOverlay[i].y, mapOverlay[i].background);
+    }
+    if (mapMarkerW > 0 && mapMarkerH > 0) // Position marker
+    {
+        tft.pushImage(mapMarkerX, mapMarkerY, mapMarkerW, mapMarkerH, mapMarkerTile);
+    }
+    for (int i = mapMarkerIndex - 1; i >= 0; i--) // Footprint
+    {
+        tft.drawPixel(mapOverlay[i].x, mapOverlay[i].y, mapOverlay[i].background);
+    }
+    tft.endWrite();
+}
+void updateGroundTrack(unsigned long now)
+{
+    // Samples in the past are dropped from the front and only the missing tail up to three orbits ahead is
+    // propagated, so a refresh costs the time elapsed since the last one rather than three orbits
+    if (groundTrackEpoch != sat.satrec.jdsatepoch || sat.revpday <= 0)
+    {
+        groundTrackEpoch = sat.satrec.jdsatepoch; // New TLE, start over
+        groundTrackHead = 0;
+        groundTrackCount = 0;
+        groundTrackPeriod = sat.revpday > 0 ? (unsigned long)(86400.0 / sat.revpday) : 86400;
+        groundTrackStep = max(GROUND_TRACK_STEP, GROUND_TRACK_ORBITS * groundTrackPeriod / (GROUND_TRACK_MAX - 1) + 1);
+    }
+    while (groundTrackCount > 0 && groundTrack[groundTrackHead].t < now)
+    {
+        groundTrackHead = (groundTrackHead + 1) % GROUND_TRACK_MAX;
+        groundTrackCount--;
+    }
+    if (groundTrackCount > 0 && groundTrack[groundTrackHead].t - now >= groundTrackStep)
+    {
+        groundTrackCount = 0; // Clock stepped back, the track no longer starts at the satellite
+    }
+    unsigned long t = now;
+    if (groundTrackCount > 0)
+    {
+        t = groundTrack[(groundTrackHead + groundTrackCount - 1) % GROUND_TRACK_MAX].t + groundTrackStep;
+    }
+    unsigned long end = now + GROUND_TRACK_ORBITS * groundTrackPeriod;
+
+    // Propagate in chunks with Sgp4::propagateRange (geodetic output only)
+    const int chunkSize = 64;
+    float chunkLat[chunkSize];
+    float chunkLon[chunkSize];
+    trackbuffer chunk = {NULL, NULL, NULL, chunkLat, chunkLon, NULL};
+    while (t < end && groundTrackCount < GROUND_TRACK_MAX)
+    {
+        int wanted = min((unsigned long)chunkSize, (end - t + groundTrackStep - 1) / groundTrackStep);
+        wanted = min(wanted, GROUND_TRACK_MAX - groundTrackCount);
+        int chunkCount = sat.propagateRange(t, (double)groundTrackStep, wanted, chunk, geodetic);
+        if (chunkCount == 0)
         {
-            hasLeftStartX = true;
+            break; // Propagation error, nothing more to draw
         }
-
-        // Check if the satellite returned close to the starting X position
-        if (hasLeftStartX && abs(x - startX) < 5)
+        for (int i = 0; i < chunkCount; i++)
         {
-            passageCount++;
-            hasLeftStartX = false;
+            // Map latitude and longitude to screen coordinates
+            GroundTrackSample &sample = groundTrack[(groundTrackHead + groundTrackCount) % GROUND_TRACK_MAX];
+            sample.t = t;
+            sample.x = map(chunkLon[i], -180, 180, 0, MAP_WIDTH);               // Longitude to X
+            sample.y = map(chunkLat[i], 90, -90, 0, MAP_HEIGHT) + MAP_OFFSET_Y; // Latitude to Y with offset
+            groundTrackCount++;
+            t += groundTrackStep;
         }
-
-        t += timeStep; // Increment time step
     }
 }
-void displayEquirectangularWorlsMap()
+float visibilityRadius(float altitudeKm, float elevationDeg)
 {
-    // https://notisrac.github.io/FileToCArray/
-    int16_t rc = png.openFLASH((uint8_t *)worldMap, sizeof(worldMap), pngDraw);
-    if (rc == PNG_SUCCESS)
+    // Angular radius (radians) of the ground from which a satellite at altitudeKm is seen above elevationDeg
+    float elevation = elevationDeg * DEG_TO_RAD;
+    return acos(EARTH_RADIUS_KM * cos(elevation) / (EARTH_RADIUS_KM + altitudeKm)) - elevation;
+}
+void plotMapLine(int x0, int y0, int x1, int y1, uint16_t color)
+{
+    // drawLine() through plotMapPixel(), so that the pixels beneath are restored with the rest of the overlays
+    int dx = abs(x1 - x0);
+    int dy = -abs(y1 - y0);
+    int sx = x0 < x1 ? 1 : -1;
+    int sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    while (true)
     {
-        Serial.println("Successfully opened png file");
-        Serial.printf("image specs: (%d x %d), %d bpp, pixel type: %d\n", png.getWidth(), png.getHeight(), png.getBpp(), png.getPixelType());
-        tft.startWrite();
-        uint32_t dt = millis();
-        rc = png.decode(NULL, 0);
-        Serial.print(millis() - dt);
-        Serial.println("ms");
-        tft.endWrite();
+        plotMapPixel(x0, y0, color);
+        if (x0 == x1 && y0 == y1)
+        {
+            break;
+        }
+        int e2 = 2 * err;
+        if (e2 >= dy)
+        {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx)
+        {
+            err += dx;
+            y0 += sy;
+        }
     }
+}
+void plotMapSegment(float lat0, float lon0, float lat1, float lon1, uint16_t color)
+{
+    // Segment that does not cross the antimeridian, in equirectangular map coordinates
+    int x0 = (lon0 + 180) * MAP_WIDTH / 360;
+    int y0 = (90 - lat0) * MAP_HEIGHT / 180 + MAP_OFFSET_Y;
+    int x1 = (lon1 + 180) * MAP_WIDTH / 360;
+    int y1 = (90 - lat1) * MAP_HEIGHT / 180 + MAP_OFFSET_Y;
+    plotMapLine(x0, y0, x1, y1, color);
+}
+void drawSmallCircle(float centerLat, float centerLon, float radius, uint16_t color)
+{
+    // Points at angular distance radius (radians) from the center: p = cos(r) c + sin(r) (cos(b) north + sin(b) east)
+    // with the unit vectors c, north and east of the center, so each point costs an asin and an atan2.
+    // The polyline is split where it crosses the antimeridian, circles around a pole come out as a wavy band.
+    if (!smallCircleTableReady)
+    {
+        for (int i = 0; i < SMALL_CIRCLE_POINTS; i++)
+        {
+            float bearing = 2 * PI * i / SMALL_CIRCLE_POINTS;
+            smallCircleCos[i] = cos(bearing);
+            smallCircleSin[i] = sin(bearing);
+        }
+        smallCircleTableReady = true;
+    }
+    float sinLat = sin(centerLat * DEG_TO_RAD);
+    float cosLat = cos(centerLat * DEG_TO_RAD);
+    float sinLon = sin(centerLon * DEG_TO_RAD);
+    float cosLon = cos(centerLon * DEG_TO_RAD);
+    float sinRadius = sin(radius);
+    float cosRadius = cos(radius);
+    float center[3] = {cosRadius * cosLat * cosLon, cosRadius * cosLat * sinLon, cosRadius * sinLat};
+    float north[3] = {-sinRadius * sinLat * cosLon, -sinRadius * sinLat * sinLon, sinRadius * cosLat};
+    float east[3] = {-sinRadius * sinLon, sinRadius * cosLon, 0};
+
+    float lastLat = 0;
+    float lastLon = 0;
+    for (int i = 0; i <= SMALL_CIRCLE_POINTS; i++)
+    {
+        int k = i % SMALL_CIRCLE_POINTS;
+        float x = center[0] + smallCircleCos[k] * north[0] + smallCircleSin[k] * east[0];
+        float y = center[1] + smallCircleCos[k] * north[1] + smallCircleSin[k] * east[1];
+        float z = center[2] + smallCircleCos[k] * north[2];
+        float lat = asin(constrain(z, -1.0f, 1.0f)) * RAD_TO_DEG;
+        float lon = atan2(y, x) * RAD_TO_DEG;
+        if (i > 0)
+        {
+            if (lastLon - lon > 180) // Crosses +180 going east
+            {
+                float crossLat = lastLat + (lat - lastLat) * (180 - lastLon) / (lon + 360 - lastLon);
+                plotMapSegment(lastLat, lastLon, crossLat, 180, color);
+                plotMapSegment(crossLat, -180, lat, lon, color);
+            }
+            else if (lon - lastLon > 180) // Crosses -180 going west
+            {
+                float crossLat = lastLat + (lat - lastLat) * (lastLon + 180) / (lastLon + 360 - lon);
+                plotMapSegment(lastLat, lastLon, crossLat, -180, color);
+                plotMapSegment(crossLat, 180, lat, lon, color);
+            }
+            else
+            {
+                plotMapSegment(lastLat, lastLon, lat, lon, color);
+            }
+        }
+        lastLat = lat;
+        lastLon = lon;
+    }
+}
+void displayMapWithMultiPasses(bool fullRedraw)
+{
+    // The map and its titles are only drawn when the page is entered, refreshes restore the pixels under the overlays
+    if (!mapOverlayComplete)
+    {
+        fullRedraw = true;
+    }
+    if (fullRedraw)
+    {
+        // Clear the screen and display the map image
+        tft.fillScreen(TFT_BLACK);
+        displayEquirectangularWorlsMap();
+    }
+    else
+    {
+        restoreMapOverlay();
+        drawMapTitles(); // The overlays may have crossed them
+    }
+    mapOverlayPixels = 0;
+    mapOverlayComplete = true;
+
+    // STEP 1: Get satellite position (kept current by updateSatPosition()) and draw the footprint
+    float startLat = sat.satLat; // Satellite latitude
+    float startLon = sat.satLon; // Satellite longitude
+    float satAlt = sat.satAlt;   // Satellite altitude
+
+    // Calculate footprint radius, the ground that sees the satellite above the horizon
+    float footprintRadius = visibilityRadius(satAlt, 0);
+    float footprintRadiusKm = EARTH_RADIUS_KM * footprintRadius;
+
+    // Debug: Print footprint radius
+    Serial.print("Footprint radius (km): ");
+    Serial.println(footprintRadiusKm);
+
+    // Draw the footprint, and around the observer the sub-satellite points from which the satellite is above MIN_ELEVATION
+    drawSmallCircle(startLat, startLon, footprintRadius, TFT_GOLD);
+    drawSmallCircle(OBSERVER_LATITUDE, OBSERVER_LONGITUDE, visibilityRadius(satAlt, MIN_ELEVATION), TFT_CYAN);
+
+    // STEP 2: Plot the starting position
+    int startX = map(startLon, -180, 180, 0, MAP_WIDTH);             // Longitude to X-coordinate
+    int startY = map(startLat, 90, -90, 0, MAP_HEIGHT) + MAP_OFFSET_Y; // Latitude to Y-coordinate with offset
+
+    // Save the tile under the marker, clipped to the screen, then mark the starting position
+    const int half = MAP_MARKER_SIZE / 2;
+    mapMarkerIndex = mapOverlayPixels;
+    mapMarkerX = max(startX - half, 0);
+    mapMarkerY = max(startY - half, 0);
+    mapMarkerW = min(startX + half + 1, WORLD_MAP_WIDTH) - mapMarkerX;
+    mapMarkerH = min(startY + half + 1, WORLD_MAP_HEIGHT) - mapMarkerY;
+    for (int row = 0; row < mapMarkerH; row++)
+    {
+        if (!mapBackgroundRow(mapMarkerX, mapMarkerY + row, mapMarkerW, mapMarkerTile + row * mapMarkerW))
+        {
+            mapOverlayComplete = false; // No map source, the next refresh redraws the map
+            break;
+        }
+    }
+    tft.fillCircle(startX, startY, 3, TFT_YELLOW); // Starting point
+    tft.drawCircle(startX, startY, 4, TFT_RED);
+    tft.drawCircle(startX, startY, 5, TFT_RED);
+
+    // Debug: Print starting position
+    Serial.print("Starting Point (X, Y): ");
+    Serial.print(startX);
+    Serial.print(", ");
+    Serial.println(startY);
+
+    // STEP 3: Plot the satellite's path for three orbits, one color per orbit
+    unixtime = timeClient.getEpochTime(); // Get the current UNIX timestamp
+    updateGroundTrack(unixtime);
+    for (int i = 0; i < groundTrackCount; i++)
+    {
+        const GroundTrackSample &sample = groundTrack[(groundTrackHead + i) % GROUND_TRACK_MAX];
+        unsigned long orbit = (sample.t - unixtime) / groundTrackPeriod;
+        uint16_t color = (orbit == 0) ? TFT_GREEN : (orbit == 1) ? TFT_YELLOW
+                                                                 : TFT_RED;
+
+        // Draw the satellite's path
+        plotMapPixel(sample.x, sample.y, color);
+    }
+}
+void displayEquirectangularWorlsMap()
+{
+    // The map is only inflated once when PSRAM can hold the decoded pixels
+    if (worldMapCacheReady)
+    {
+        uint32_t dt = millis();
+        tft.pushImage(0, 0, WORLD_MAP_WIDTH, WORLD_MAP_HEIGHT, worldMapCache);
+        Serial.print(millis() - dt);
+        Serial.println("ms (cached map)");
+    }
+    else
+    {
+        if (worldMapCache == NULL && psramFound())
+        {
+            worldMapCache = (uint16_t *)ps_malloc(WORLD_MAP_WIDTH * WORLD_MAP_HEIGHT * sizeof(uint16_t));
+        }
+#ifdef WORLD_MAP_RLE
+        tft.startWrite();
+        uint32_t dt = millis();
+        pngDrawCache = worldMapCache;
+        bool drawn = drawRleImage(worldMapRle, worldMapRows);
+        pngDrawCache = NULL;
+        worldMapRowsReady = drawn;
+        worldMapRowY = -1;
+        Serial.print(millis() - dt);
+        Serial.println("ms (RLE)");
+        tft.endWrite();
+        worldMapCacheReady = worldMapCache != NULL && drawn; // drawRleImage() fills the cache row by row
+#else
+        // https://notisrac.github.io/FileToCArray/
+        int16_t rc = png.openFLASH((uint8_t *)worldMap, sizeof(worldMap), pngDraw);
+        if (rc == PNG_SUCCESS)
+        {
+            Serial.println("Successfully opened png file");
+            Serial.printf("image specs: (%d x %d), %d bpp, pixel type: %d\n", png.getWidth(), png.getHeight(), png.getBpp(), png.getPixelType());
+            tft.startWrite();
+            uint32_t dt = millis();
+            pngDrawCache = worldMapCache;
+            rc = decodePNG();
+            pngDrawCache = NULL;
+            Serial.print(millis() - dt);
+            Serial.println("ms");
+            tft.endWrite();
+            worldMapCacheReady = worldMapCache != NULL && rc == PNG_SUCCESS &&
+                                 png.getWidth() == WORLD_MAP_WIDTH && png.getHeight() == WORLD_MAP_HEIGHT;
+        }
+#endif
+    }
+    drawMapTitles();
+}
+void drawMapTitles()
+{
+    String text = String(SatNameCharArray) + " Next 3 Passes";
+
+    // Set the text font to FONT4
+    tft.setTextFont(4);
 
-    String text = String(SatNameCharArray) + " Next 3 Passes";
-
-    // Set the text font to FONT4
-    tft.setTextFont(4);
-
     // Calculate the width of the text to center it
     int textWidth = tft.textWidth(text);
 
@@ -2757,225 +3936,1001 @@ void calibrateTFTscreen()
 
     for (String line : instructions)
     {
-        int16_t xPos = (tft.width() - tft.textWidth(line)) / 2;
-        tft.setCursor(xPos, yPos);
-        tft.print(line);
-        yPos += tft.fontHeight();
+        int16_t xPos = (tft.width() - tft.textWidth(line)) / 2;
+        tft.setCursor(xPos, yPos);
+        tft.print(line);
+        yPos += tft.fontHeight();
+    }
+
+    tft.setTextColor(TFT_GREEN, TFT_BLACK);
+    tft.setCursor((tft.width() - tft.textWidth(instructions[6])) / 2, yPos);
+    tft.print(instructions[6]);
+
+    while (true)
+    {
+        uint16_t x, y;
+        if (tft.getTouch(&x, &y))
+        {
+            break;
+        }
+    }
+
+    tft.fillScreen(TFT_BLACK);
+
+    tft.calibrateTouch(calibrationData, TFT_GREEN, TFT_BLACK, 12);
+
+    preferences.begin("TFT", false);
+    for (int i = 0; i < 5; i++)
+    {
+        preferences.putUInt(("calib" + String(i)).c_str(), calibrationData[i]);
+    }
+    preferences.end();
+
+    // Test calibration with dynamic feedback
+    tft.fillScreen(TFT_BLACK);
+    uint16_t x, y;
+    int16_t lastX = -1, lastY = -1;
+    String lastResult = "";
+
+    tft.setTextColor(TFT_WHITE, TFT_BLACK);
+    tft.setTextFont(4);
+    String text = "Tap anywhere to test";
+    tft.setCursor((tft.width() - tft.textWidth(text)) / 2, 8);
+    tft.print(text);
+
+    text = "Click Here to Exit";
+    int16_t btn_w = tft.textWidth(text) + 20;
+    int16_t btn_h = tft.fontHeight() + 12;
+    int16_t btn_x = (tft.width() - btn_w) / 2;
+    int16_t btn_y = 280;
+    int16_t btn_r = 10;
+
+    tft.fillRoundRect(btn_x, btn_y, btn_w, btn_h, btn_r, TFT_BLUE);
+    tft.drawRoundRect(btn_x, btn_y, btn_w, btn_h, btn_r, TFT_WHITE);
+    tft.setTextColor(TFT_WHITE, TFT_BLUE);
+    tft.setCursor((tft.width() - tft.textWidth(text)) / 2, btn_y + 10);
+    tft.print(text);
+
+    while (true)
+    {
+        if (tft.getTouch(&x, &y))
+        {
+            String result = "x=" + String(x) + "  y=" + String(y) + "  p=" + String(tft.getTouchRawZ());
+
+            tft.setTextColor(TFT_BLACK, TFT_BLACK);
+            tft.setCursor(lastX, lastY);
+            tft.print(lastResult);
+
+            int16_t textWidth = tft.textWidth(result);
+            int16_t xPos = (tft.width() - textWidth) / 2;
+            int16_t yPos = (tft.height() - tft.fontHeight()) / 2;
+
+            tft.setTextColor(TFT_GREEN, TFT_BLACK);
+            tft.setCursor(xPos, yPos);
+            tft.print(result);
+
+            lastX = xPos;
+            lastY = yPos;
+            lastResult = result;
+
+            tft.fillCircle(x, y, 2, TFT_RED);
+
+            if (x > btn_x && x < btn_x + btn_w && y > btn_y && y < btn_y + btn_h)
+            {
+                Serial.println("Exit Touched");
+                break;
+            }
+        }
+    }
+
+    tft.fillScreen(TFT_BLACK);
+}
+void checkAndApplyTFTCalibrationData(bool recalibrate)
+{
+    if (recalibrate)
+    {
+        calibrateTFTscreen();
+        return;
+    }
+
+    uint16_t calibrationData[5];
+    preferences.begin("TFT", true);
+    bool dataValid = true;
+
+    for (int i = 0; i < 5; i++)
+    {
+        calibrationData[i] = preferences.getUInt(("calib" + String(i)).c_str(), 0xFFFF);
+        if (calibrationData[i] == 0xFFFF)
+        {
+            dataValid = false;
+        }
+    }
+    preferences.end();
+
+    if (dataValid)
+    {
+        tft.setTouch(calibrationData);
+        Serial.println("Calibration data applied.");
+    }
+    else
+    {
+        Serial.println("Invalid calibration data. Recalibrating...");
+        calibrateTFTscreen();
+    }
+}
+void drawSpeakerON(int x, int y)
+{ // Clear the previous display area with a black rectangle
+    int width = 30;
+    int height = 30;
+    tft.fillRect(x, y, width, height, TFT_BLACK);
+
+    // tft.drawRect(x - 30, y - 30, width + 60, height + 60, TFT_YELLOW); //touch rectangle
+    // Function to draw a bold line
+    auto drawBoldLine = [&](int x0, int y0, int x1, int y1, uint16_t color, int thickness)
+    {
+        for (int i = -thickness / 2; i <= thickness / 2; i++)
+        {
+            tft.drawLine(x0 + i, y0, x1 + i, y1, color);
+            tft.drawLine(x0, y0 + i, x1, y1 + i, color);
+        }
+    };
+
+    float scale = 1.1; // Scaling factor
+    int thickness = 1; // Line thickness
+
+    // Semi-transparent filled shape (speaker body)
+    tft.fillTriangle(
+        x + scale * 13, y + scale * 3,
+        x + scale * 7, y + scale * 8,
+        x + scale * 5, y + scale * 8,
+        TFT_DARKGREY);
+
+    // Main outline of the speaker
+    drawBoldLine(x + scale * 13, y + scale * 3, x + scale * 7, y + scale * 8, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 7, y + scale * 8, x + scale * 5, y + scale * 8, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 5, y + scale * 8, x + scale * 3, y + scale * 10, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 3, y + scale * 10, x + scale * 3, y + scale * 14, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 3, y + scale * 14, x + scale * 5, y + scale * 16, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 5, y + scale * 16, x + scale * 7, y + scale * 16, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 7, y + scale * 16, x + scale * 13, y + scale * 21, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 13, y + scale * 21, x + scale * 13, y + scale * 3, TFT_WHITE, thickness);
+
+    // Curved sound waves
+    drawBoldLine(x + scale * 16, y + scale * 9, x + scale * 17, y + scale * 12, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 17, y + scale * 12, x + scale * 16, y + scale * 15, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 19, y + scale * 6, x + scale * 20, y + scale * 12, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 20, y + scale * 12, x + scale * 19, y + scale * 18, TFT_WHITE, thickness);
+}
+void drawSpeakerOFF(int x, int y)
+{
+    // Clear the previous display area with a black rectangle
+    int width = 30;
+    int height = 30;
+    tft.fillRect(x, y, width, height, TFT_BLACK);
+
+    // Function to draw a bold line
+    auto drawBoldLine = [&](int x0, int y0, int x1, int y1, uint16_t color, int thickness)
+    {
+        for (int i = -thickness / 2; i <= thickness / 2; i++)
+        {
+            tft.drawLine(x0 + i, y0, x1 + i, y1, color);
+            tft.drawLine(x0, y0 + i, x1, y1 + i, color);
+        }
+    };
+
+    float scale = 1.2; // Scaling factor
+    int thickness = 1; // Line thickness
+
+    // Semi-transparent filled shape (speaker body)
+    tft.fillTriangle(
+        x + scale * 13, y + scale * 3,
+        x + scale * 7, y + scale * 8,
+        x + scale * 5, y + scale * 8,
+        TFT_DARKGREY);
+
+    // Main outline of the speaker
+    drawBoldLine(x + scale * 13, y + scale * 3, x + scale * 7, y + scale * 8, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 7, y + scale * 8, x + scale * 5, y + scale * 8, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 5, y + scale * 8, x + scale * 3, y + scale * 10, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 3, y + scale * 10, x + scale * 3, y + scale * 14, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 3, y + scale * 14, x + scale * 5, y + scale * 16, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 5, y + scale * 16, x + scale * 7, y + scale * 16, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 7, y + scale * 16, x + scale * 13, y + scale * 21, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 13, y + scale * 21, x + scale * 13, y + scale * 3, TFT_WHITE, thickness);
+
+    // Cross lines
+    drawBoldLine(x + scale * 16, y + scale * 9, x + scale * 22, y + scale * 15, TFT_WHITE, thickness);
+    drawBoldLine(x + scale * 22, y + scale * 9, x + scale * 16, y + scale * 15, TFT_WHITE, thickness);
+}
+void telemetryAppend(const char *text)
+{
+    // Appends to telemetryFrame, always leaves it terminated
+    while (*text != 0 && telemetryLength < TELEMETRY_FRAME_SIZE - 1)
+    {
+        telemetryFrame[telemetryLength++] = *text++;
+    }
+    telemetryFrame[telemetryLength] = 0;
+}
+void telemetryAppendFixed(double value)
+{
+    // Two decimals like String(double), without the heap used by printf's float formatting
+    if (isnan(value) || isinf(value))
+    {
+        telemetryAppend("null");
+        return;
+    }
+    char digits[24];
+    int n = sizeof(digits) - 1;
+    digits[n] = 0;
+    unsigned long long scaled = (unsigned long long)(fabs(value) * 100 + 0.5);
+    for (int i = 0; i < 2; i++)
+    {
+        digits[--n] = '0' + scaled % 10;
+        scaled /= 10;
+    }
+    digits[--n] = '.';
+    do
+    {
+        digits[--n] = '0' + scaled % 10;
+        scaled /= 10;
+    } while (scaled > 0 && n > 1);
+    if (value < 0 && strcmp(digits + n, "0.00") != 0)
+    {
+        digits[--n] = '-';
+    }
+    telemetryAppend(digits + n);
+}
+void formatTelemetryTime(char *time)
+{
+    // "HH:MM:SS" local time into time[9], same as formatTimeOnly(unixtime, true)
+    unsigned long secondOfDay = (unixtime + totalTimeOffset) % 86400;
+    strcpy(time, "00:00:00");
+    time[0] += secondOfDay / 36000;
+    time[1] += secondOfDay / 3600 % 10;
+    time[3] += secondOfDay % 3600 / 600;
+    time[4] += secondOfDay % 600 / 60;
+    time[6] += secondOfDay % 60 / 10;
+    time[7] += secondOfDay % 10;
+}
+double telemetryNumber(int field)
+{
+    // Value of a numeric field
+    switch (field)
+    {
+    case TELEMETRY_ALTITUDE:
+        return telemetryPosition.satAlt;
+    case TELEMETRY_AZIMUTH:
+        return telemetryPosition.satAz;
+    case TELEMETRY_ELEVATION:
+        return telemetryPosition.satEl;
+    case TELEMETRY_LATITUDE:
+        return telemetryPosition.satLat;
+    case TELEMETRY_LONGITUDE:
+        return telemetryPosition.satLon;
+    case TELEMETRY_DISTANCE:
+        return telemetryPosition.satDist;
+    case TELEMETRY_SUN_AZIMUTH:
+        return sat.sunAz;
+    case TELEMETRY_SUN_ELEVATION:
+        return sat.sunEl;
+    case TELEMETRY_TIMESTAMP:
+        return telemetryTime;
+    case TELEMETRY_RANGE_RATE:
+        return telemetryPosition.satRangeRate;
+    }
+    return NAN;
+}
+size_t encodeTelemetry(uint16_t fields)
+{
+    // {"satName":"ISS (ZARYA)","time":"21:04:05","altitude":418.25,...} with the selected fields
+    telemetryLength = 0;
+    telemetryAppend("{");
+    for (int field = 0; field < TELEMETRY_FIELD_COUNT; field++)
+    {
+        if ((fields & (1 << field)) == 0)
+        {
+            continue;
+        }
+        telemetryAppend(telemetryLength > 1 ? ",\"" : "\"");
+        telemetryAppend(telemetryFieldNames[field]);
+        telemetryAppend("\":");
+        if (field == TELEMETRY_SAT_NAME)
+        {
+            telemetryAppend("\"");
+            for (const char *c = sat.satName; *c != 0; c++)
+            {
+                char escaped[3] = {'\\', *c, 0};
+                telemetryAppend(*c == '"' || *c == '\\' ? escaped : escaped + 1);
+            }
+            telemetryAppend("\"");
+        }
+        else if (field == TELEMETRY_TIME)
+        {
+            char time[9];
+            formatTelemetryTime(time);
+            telemetryAppend("\"");
+            telemetryAppend(time);
+            telemetryAppend("\"");
+        }
+        else if (field == TELEMETRY_PASS)
+        {
+            if (nextPassStart == 0)
+            {
+                telemetryAppend("null");
+                continue;
+            }
+            char number[12];
+            telemetryAppend("{\"state\":\"");
+            telemetryAppend(passStateNames[passState]);
+            telemetryAppend("\",\"aos\":");
+            telemetryAppend(ultoa(nextPassStart, number, 10));
+            telemetryAppend(",\"tca\":");
+            telemetryAppend(ultoa(nextPassCulminationTime, number, 10));
+            telemetryAppend(",\"los\":");
+            telemetryAppend(ultoa(nextPassEnd, number, 10));
+            telemetryAppend(",\"maxElevation\":");
+            telemetryAppendFixed(nextPassMaxTCA);
+            telemetryAppend(",\"aosAzimuth\":");
+            telemetryAppendFixed(nextPassAOSAzimuth);
+            telemetryAppend(",\"losAzimuth\":");
+            telemetryAppendFixed(nextPassLOSAzimuth);
+            telemetryAppend("}");
+        }
+        else
+        {
+            telemetryAppendFixed(telemetryNumber(field));
+        }
+    }
+    telemetryAppend("}");
+    return telemetryLength;
+}
+void msgpackAppend(const uint8_t *data, size_t length)
+{
+    // Appends to telemetryPacked, a frame that does not fit is truncated (the buffer is sized for the longest one)
+    while (length-- > 0 && telemetryPackedLength < TELEMETRY_PACKED_SIZE)
+    {
+        telemetryPacked[telemetryPackedLength++] = *data++;
+    }
+}
+void msgpackAppendByte(uint8_t value)
+{
+    msgpackAppend(&value, 1);
+}
+void msgpackAppendString(const char *text)
+{
+    // fixstr up to 31 bytes, str8 above
+    size_t length = strlen(text);
+    if (length > 255)
+    {
+        length = 255;
+    }
+    if (length < 32)
+    {
+        msgpackAppendByte(0xa0 | length);
+    }
+    else
+    {
+        msgpackAppendByte(0xd9);
+        msgpackAppendByte(length);
+    }
+    msgpackAppend((const uint8_t *)text, length);
+}
+void msgpackAppendUint(uint32_t value)
+{
+    // uint32, big endian
+    uint8_t bytes[5] = {0xce, (uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value};
+    msgpackAppend(bytes, sizeof(bytes));
+}
+void msgpackAppendFloat(double value)
+{
+    // float32, big endian; nil for NaN and inf like the JSON null
+    if (isnan(value) || isinf(value))
+    {
+        msgpackAppendByte(0xc0);
+        return;
+    }
+    float single = value;
+    uint32_t bits;
+    memcpy(&bits, &single, sizeof(bits));
+    uint8_t bytes[5] = {0xca, (uint8_t)(bits >> 24), (uint8_t)(bits >> 16), (uint8_t)(bits >> 8), (uint8_t)bits};
+    msgpackAppend(bytes, sizeof(bytes));
+}
+void msgpackAppendDouble(double value)
+{
+    // float64, big endian, for the Unix timestamp that float32 cannot hold to the millisecond
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    msgpackAppendByte(0xcb);
+    for (int shift = 56; shift >= 0; shift -= 8)
+    {
+        msgpackAppendByte(bits >> shift);
+    }
+}
+void msgpackAppendArray(uint16_t count)
+{
+    // fixarray up to 15 entries, array16 above
+    if (count < 16)
+    {
+        msgpackAppendByte(0x90 | count);
+        return;
+    }
+    msgpackAppendByte(0xdc);
+    msgpackAppendByte(count >> 8);
+    msgpackAppendByte(count);
+}
+size_t encodeTelemetryMsgpack(uint16_t fields)
+{
+    // The selected fields with the JSON keys, floats as float32, "pass": nil or a map of the next pass
+    telemetryPackedLength = 0;
+    int count = 0;
+    for (int field = 0; field < TELEMETRY_FIELD_COUNT; field++)
+    {
+        count += (fields >> field) & 1;
+    }
+    msgpackAppendByte(0x80 | count); // fixmap, at most TELEMETRY_FIELD_COUNT entries
+    for (int field = 0; field < TELEMETRY_FIELD_COUNT; field++)
+    {
+        if ((fields & (1 << field)) == 0)
+        {
+            continue;
+        }
+        msgpackAppendString(telemetryFieldNames[field]);
+        if (field == TELEMETRY_SAT_NAME)
+        {
+            msgpackAppendString(sat.satName);
+        }
+        else if (field == TELEMETRY_TIME)
+        {
+            char time[9];
+            formatTelemetryTime(time);
+            msgpackAppendString(time);
+        }
+        else if (field == TELEMETRY_TIMESTAMP)
+        {
+            msgpackAppendDouble(telemetryTime);
+        }
+        else if (field == TELEMETRY_PASS)
+        {
+            if (nextPassStart == 0)
+            {
+                msgpackAppendByte(0xc0);
+                continue;
+            }
+            // AOS, TCA and LOS as Unix time (UTC)
+            msgpackAppendByte(0x80 | 7);
+            msgpackAppendString("state");
+            msgpackAppendString(passStateNames[passState]);
+            msgpackAppendString("aos");
+            msgpackAppendUint(nextPassStart);
+            msgpackAppendString("tca");
+            msgpackAppendUint(nextPassCulminationTime);
+            msgpackAppendString("los");
+            msgpackAppendUint(nextPassEnd);
+            msgpackAppendString("maxElevation");
+            msgpackAppendFloat(nextPassMaxTCA);
+            msgpackAppendString("aosAzimuth");
+            msgpackAppendFloat(nextPassAOSAzimuth);
+            msgpackAppendString("losAzimuth");
+            msgpackAppendFloat(nextPassLOSAzimuth);
+        }
+        else
+        {
+            msgpackAppendFloat(telemetryNumber(field));
+        }
+    }
+    return telemetryPackedLength;
+}
+int passTrackStep()
+{
+    // Seconds between the points of the pass track, at most PASS_TRACK_POINTS points from AOS to LOS
+    int step = (nextPassEnd - nextPassStart + PASS_TRACK_POINTS - 2) / (PASS_TRACK_POINTS - 1);
+    return max(step, PASS_TRACK_STEP);
+}
+size_t encodePassTrack(TelemetryFormat format)
+{
+    // {"passTrack":{"aos":..,"los":..,"step":5,"azimuth":[..],"elevation":[..]}}, read from the pass ephemeris
+    int step = passTrackStep();
+    int points = (nextPassEnd - nextPassStart) / step + 1;
+    if (format == TELEMETRY_JSON)
+    {
+        char number[12];
+        telemetryLength = 0;
+        telemetryAppend("{\"passTrack\":{\"aos\":");
+        telemetryAppend(ultoa(nextPassStart, number, 10));
+        telemetryAppend(",\"los\":");
+        telemetryAppend(ultoa(nextPassEnd, number, 10));
+        telemetryAppend(",\"step\":");
+        telemetryAppend(ultoa(step, number, 10));
+        for (int axis = 0; axis < 2; axis++)
+        {
+            telemetryAppend(axis == 0 ? ",\"azimuth\":[" : "],\"elevation\":[");
+            for (int i = 0; i < points; i++)
+            {
+                passEphemeris.evaluate(nextPassStart + (unsigned long)i * step);
+                telemetryAppend(i > 0 ? "," : "");
+                telemetryAppendFixed(axis == 0 ? passEphemeris.satAz : passEphemeris.satEl);
+            }
+        }
+        telemetryAppend("]}}");
+        return telemetryLength;
+    }
+    telemetryPackedLength = 0;
+    msgpackAppendByte(0x80 | 1);
+    msgpackAppendString("passTrack");
+    msgpackAppendByte(0x80 | 5);
+    msgpackAppendString("aos");
+    msgpackAppendUint(nextPassStart);
+    msgpackAppendString("los");
+    msgpackAppendUint(nextPassEnd);
+    msgpackAppendString("step");
+    msgpackAppendUint(step);
+    for (int axis = 0; axis < 2; axis++)
+    {
+        msgpackAppendString(axis == 0 ? "azimuth" : "elevation");
+        msgpackAppendArray(points);
+        for (int i = 0; i < points; i++)
+        {
+            passEphemeris.evaluate(nextPassStart + (unsigned long)i * step);
+            msgpackAppendFloat(axis == 0 ? passEphemeris.satAz : passEphemeris.satEl);
+        }
+    }
+    return telemetryPackedLength;
+}
+double fractionalUnixtime()
+{
+    // unixtime plus the milliseconds since it last changed, for the outputs faster than 1 Hz
+    static unsigned long lastUnixtime = 0;
+    static unsigned long unixtimeMillis = 0; // millis() when unixtime last changed
+    if (unixtime != lastUnixtime)
+    {
+        lastUnixtime = unixtime;
+        unixtimeMillis = millis();
+    }
+    return unixtime + min(millis() - unixtimeMillis, 999UL) / 1000.0;
+}
+void updateTelemetryPosition()
+{
+    // Position at the fractional time telemetryTime from the pass ephemeris, for clients faster than the 1 Hz of
+    // updateSatPosition(); outside the ephemeris span the position at unixtime is copied from sat
+    telemetryTime = fractionalUnixtime();
+    if (telemetryTime != unixtime && passEphemeris.evaluate(getJulianFromUnix(telemetryTime)))
+    {
+        telemetryPosition.satAz = passEphemeris.satAz;
+        telemetryPosition.satEl = passEphemeris.satEl;
+        telemetryPosition.satDist = passEphemeris.satDist;
+        telemetryPosition.satLat = passEphemeris.satLat;
+        telemetryPosition.satLon = passEphemeris.satLon;
+        telemetryPosition.satAlt = passEphemeris.satAlt;
+        telemetryPosition.satRangeRate = passEphemeris.satRangeRate;
+        return;
+    }
+    telemetryTime = unixtime;
+    telemetryPosition.satAz = sat.satAz;
+    telemetryPosition.satEl = sat.satEl;
+    telemetryPosition.satDist = sat.satDist;
+    telemetryPosition.satLat = sat.satLat;
+    telemetryPosition.satLon = sat.satLon;
+    telemetryPosition.satAlt = sat.satAlt;
+    telemetryPosition.satRangeRate = sat.satRangeRate;
+}
+void serviceTelemetry()
+{
+    // Sends the frames that are due, whatever page is on screen; clients due together with the
+    // same format and fields share one encoding
+    unsigned long now = millis();
+    bool positionUpdated = false;
+    int jsonFields = -1;   // Fields currently encoded in telemetryFrame
+    int packedFields = -1; // Fields currently encoded in telemetryPacked
+    bool encoderAllocated = false;
+    for (int i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++)
+    {
+        TelemetryClient &client = telemetryClients[i];
+        if (client.format == TELEMETRY_NONE || now - client.lastSent < client.interval)
+        {
+            continue;
+        }
+        // Keep the cadence, unless the loop was held up for more than a period
+        client.lastSent = now - client.lastSent < 2 * client.interval ? client.lastSent + client.interval : now;
+        if (!positionUpdated)
+        {
+            updateTelemetryPosition();
+            positionUpdated = true;
+        }
+        if (client.format == TELEMETRY_JSON)
+        {
+            if (jsonFields != client.fields)
+            {
+                uint32_t heapBefore = ESP.getFreeHeap();
+                encodeTelemetry(client.fields);
+                encoderAllocated |= ESP.getFreeHeap() < heapBefore;
+                jsonFields = client.fields;
+            }
+            webSocket.sendTXT(i, telemetryFrame, telemetryLength);
+        }
+        else
+        {
+            if (packedFields != client.fields)
+            {
+                uint32_t heapBefore = ESP.getFreeHeap();
+                encodeTelemetryMsgpack(client.fields);
+                encoderAllocated |= ESP.getFreeHeap() < heapBefore;
+                packedFields = client.fields;
+            }
+            webSocket.sendBIN(i, telemetryPacked, telemetryPackedLength);
+        }
+        telemetryFrames++;
+        // The pass track once per pass, once the ephemeris is fitted for it
+        if (client.passTrack && client.passTrackSent != nextPassStart && nextPassStart != 0 && passTrackForPass == nextPassStart)
+        {
+            uint32_t heapBefore = ESP.getFreeHeap();
+            encodePassTrack(client.format);
+            encoderAllocated |= ESP.getFreeHeap() < heapBefore;
+            if (client.format == TELEMETRY_JSON)
+            {
+                webSocket.sendTXT(i, telemetryFrame, telemetryLength);
+            }
+            else
+            {
+                webSocket.sendBIN(i, telemetryPacked, telemetryPackedLength);
+            }
+            client.passTrackSent = nextPassStart;
+            jsonFields = -1;
+            packedFields = -1;
+        }
+    }
+    // The free heap is only compared around the encoder calls, the WebSocket sends allocate on their own
+    if (encoderAllocated)
+    {
+        telemetryHeapAllocations++;
+    }
+}
+void subscribeTelemetry(uint8_t num, char *command)
+{
+    // subscribe [json|msgpack] [rate=<Hz>] [fields=<name>,<name>,...] [track]
+    // Options not given fall back to the defaults: JSON, 1 Hz, the original fields, no pass track
+    TelemetryClient &client = telemetryClients[num];
+    client.format = TELEMETRY_JSON;
+    client.interval = 1000;
+    client.fields = 0;
+    client.passTrack = false;
+    client.passTrackSent = 0;
+    char *save;
+    strtok_r(command, " ", &save); // "subscribe"
+    for (char *option = strtok_r(NULL, " ", &save); option != NULL; option = strtok_r(NULL, " ", &save))
+    {
+        if (strcmp(option, "json") == 0)
+        {
+            client.format = TELEMETRY_JSON;
+        }
+        else if (strcmp(option, "msgpack") == 0)
+        {
+            client.format = TELEMETRY_MSGPACK;
+        }
+        else if (strcmp(option, "track") == 0)
+        {
+            client.passTrack = true;
+        }
+        else if (strncmp(option, "rate=", 5) == 0)
+        {
+            double rate = constrain(atof(option + 5), TELEMETRY_RATE_MIN, TELEMETRY_RATE_MAX);
+            client.interval = 1000 / rate;
+        }
+        else if (strncmp(option, "fields=", 7) == 0)
+        {
+            char *fieldSave;
+            for (char *name = strtok_r(option + 7, ",", &fieldSave); name != NULL; name = strtok_r(NULL, ",", &fieldSave))
+            {
+                int field = 0;
+                while (field < TELEMETRY_FIELD_COUNT && strcmp(name, telemetryFieldNames[field]) != 0)
+                {
+                    field++;
+                }
+                if (field < TELEMETRY_FIELD_COUNT)
+                {
+                    client.fields |= 1 << field;
+                }
+                else
+                {
+                    Serial.printf("Client %u: unknown field %s\n", num, name);
+                }
+            }
+        }
+        else
+        {
+            Serial.printf("Client %u: unknown option %s\n", num, option);
+        }
+    }
+    if (client.fields == 0)
+    {
+        client.fields = client.format == TELEMETRY_JSON ? TELEMETRY_FIELDS_JSON : TELEMETRY_FIELDS_MSGPACK;
+    }
+    client.lastSent = millis() - client.interval; // First frame on the next loop
+    Serial.printf("Client %u subscribed: %s, %lu ms, fields 0x%03x%s\n", num, client.format == TELEMETRY_JSON ? "json" : "msgpack",
+                  client.interval, client.fields, client.passTrack ? ", pass track" : "");
+}
+void webSocketEvent(uint8_t num, WStype_t type, uint8_t *payload, size_t length)
+{
+    if (num >= WEBSOCKETS_SERVER_CLIENT_MAX)
+    {
+        return;
+    }
+    switch (type)
+    {
+    case WStype_CONNECTED:
+        Serial.printf("Client %u connected\n", num);
+        // Same frames as before the subscriptions existed until the client asks otherwise
+        telemetryClients[num] = TelemetryClient();
+        telemetryClients[num].format = TELEMETRY_JSON;
+        telemetryClients[num].fields = TELEMETRY_FIELDS_JSON;
+        telemetryClients[num].interval = 1000;
+        telemetryClients[num].lastSent = millis();
+        break;
+    case WStype_DISCONNECTED:
+        Serial.printf("Client %u disconnected\n", num);
+        telemetryClients[num].format = TELEMETRY_NONE;
+        break;
+    case WStype_TEXT:
+    {
+        Serial.printf("Client %u sent: %s\n", num, payload);
+        char command[160];
+        strlcpy(command, (const char *)payload, min(length + 1, sizeof(command)));
+        if (strncmp(command, "subscribe", 9) == 0 && (command[9] == 0 || command[9] == ' '))
+        {
+            subscribeTelemetry(num, command);
+        }
+        else if (strcmp(command, "unsubscribe") == 0)
+        {
+            telemetryClients[num].format = TELEMETRY_NONE; // Stays connected, receives nothing
+        }
+        break;
+    }
+    }
+}
+void rotatorTarget(double unixSeconds, double &azimuth, double &elevation)
+{
+    // The satellite during the pass window, the AOS azimuth at 0° while waiting for the next pass,
+    // otherwise the satellite position; the elevation never goes below the horizon
+    if (passEphemeris.evaluate(getJulianFromUnix(unixSeconds)))
+    {
+        azimuth = passEphemeris.satAz;
+        elevation = max(passEphemeris.satEl, 0.0);
+    }
+    else if (nextPassStart != 0 && unixSeconds < nextPassStart)
+    {
+        azimuth = nextPassAOSAzimuth;
+        elevation = 0;
+    }
+    else
+    {
+        azimuth = sat.satAz;
+        elevation = max(sat.satEl, 0.0);
+    }
+}
+void rotctldCommand(WiFiClient &client, char *line)
+{
+    // One line of the rotctld protocol, short ("p") or long ("\get_pos") command names
+    char *save;
+    char *command = strtok_r(line, " \t", &save);
+    if (command == NULL)
+    {
+        return;
     }
-
-    tft.setTextColor(TFT_GREEN, TFT_BLACK);
-    tft.setCursor((tft.width() - tft.textWidth(instructions[6])) / 2, yPos);
-    tft.print(instructions[6]);
-
-    while (true)
+    char response[160];
+    if (strcmp(command, "p") == 0 || strcmp(command, "\\get_pos") == 0)
     {
-        uint16_t x, y;
-        if (tft.getTouch(&x, &y))
-        {
-            break;
-        }
+        double azimuth, elevation;
+        rotatorTarget(fractionalUnixtime(), azimuth, elevation);
+        snprintf(response, sizeof(response), "%.6f\n%.6f\n", azimuth, elevation);
     }
-
-    tft.fillScreen(TFT_BLACK);
-
-    tft.calibrateTouch(calibrationData, TFT_GREEN, TFT_BLACK, 12);
-
-    preferences.begin("TFT", false);
-    for (int i = 0; i < 5; i++)
+    else if (strcmp(command, "P") == 0 || strcmp(command, "\\set_pos") == 0)
     {
-        preferences.putUInt(("calib" + String(i)).c_str(), calibrationData[i]);
+        // The position follows the satellite; the command is acknowledged so that clients driving a rotator can connect
+        char *azimuth = strtok_r(NULL, " \t", &save);
+        char *elevation = strtok_r(NULL, " \t", &save);
+        strcpy(response, azimuth != NULL && elevation != NULL ? "RPRT 0\n" : "RPRT -1\n");
     }
-    preferences.end();
-
-    // Test calibration with dynamic feedback
-    tft.fillScreen(TFT_BLACK);
-    uint16_t x, y;
-    int16_t lastX = -1, lastY = -1;
-    String lastResult = "";
-
-    tft.setTextColor(TFT_WHITE, TFT_BLACK);
-    tft.setTextFont(4);
-    String text = "Tap anywhere to test";
-    tft.setCursor((tft.width() - tft.textWidth(text)) / 2, 8);
-    tft.print(text);
-
-    text = "Click Here to Exit";
-    int16_t btn_w = tft.textWidth(text) + 20;
-    int16_t btn_h = tft.fontHeight() + 12;
-    int16_t btn_x = (tft.width() - btn_w) / 2;
-    int16_t btn_y = 280;
-    int16_t btn_r = 10;
-
-    tft.fillRoundRect(btn_x, btn_y, btn_w, btn_h, btn_r, TFT_BLUE);
-    tft.drawRoundRect(btn_x, btn_y, btn_w, btn_h, btn_r, TFT_WHITE);
-    tft.setTextColor(TFT_WHITE, TFT_BLUE);
-    tft.setCursor((tft.width() - tft.textWidth(text)) / 2, btn_y + 10);
-    tft.print(text);
-
-    while (true)
+    else if (strcmp(command, "S") == 0 || strcmp(command, "\\stop") == 0 || strcmp(command, "K") == 0 || strcmp(command, "\\park") == 0)
     {
-        if (tft.getTouch(&x, &y))
-        {
-            String result = "x=" + String(x) + "  y=" + String(y) + "  p=" + String(tft.getTouchRawZ());
-
-            tft.setTextColor(TFT_BLACK, TFT_BLACK);
-            tft.setCursor(lastX, lastY);
-            tft.print(lastResult);
-
-            int16_t textWidth = tft.textWidth(result);
-            int16_t xPos = (tft.width() - textWidth) / 2;
-            int16_t yPos = (tft.height() - tft.fontHeight()) / 2;
-
-            tft.setTextColor(TFT_GREEN, TFT_BLACK);
-            tft.setCursor(xPos, yPos);
-            tft.print(result);
-
-            lastX = xPos;
-            lastY = yPos;
-            lastResult = result;
-
-            tft.fillCircle(x, y, 2, TFT_RED);
-
-            if (x > btn_x && x < btn_x + btn_w && y > btn_y && y < btn_y + btn_h)
-            {
-                Serial.println("Exit Touched");
-                break;
-            }
-        }
+        strcpy(response, "RPRT 0\n");
     }
-
-    tft.fillScreen(TFT_BLACK);
+    else if (strcmp(command, "_") == 0 || strcmp(command, "\\get_info") == 0)
+    {
+        strcpy(response, "ESP32 ISS Tracker\n");
+    }
+    else if (strcmp(command, "\\dump_state") == 0)
+    {
+        // Sent by rotctl -m 2 when it connects: protocol version, model, azimuth and elevation limits
+        strcpy(response, "1\n1\n0.000000\n360.000000\n0.000000\n90.000000\nsouth_zero=0\nrot_type=AzEl\ndone\n");
+    }
+    else if (strcmp(command, "q") == 0 || strcmp(command, "Q") == 0 || strcmp(command, "\\quit") == 0)
+    {
+        client.stop();
+        return;
+    }
+    else
+    {
+        strcpy(response, "RPRT -4\n"); // Not implemented
+    }
+    client.write((const uint8_t *)response, strlen(response));
 }
-void checkAndApplyTFTCalibrationData(bool recalibrate)
+bool connectOutput(WiFiClient &client, const char *host, uint16_t port, unsigned long &lastAttempt)
 {
-    if (recalibrate)
+    // Connects an output client (rotctld, rigctld), at most once every OUTPUT_RETRY_INTERVAL while the server is unreachable
+    if (client.connected())
+    {
+        return true;
+    }
+    if (lastAttempt != 0 && millis() - lastAttempt < OUTPUT_RETRY_INTERVAL)
+    {
+        return false;
+    }
+    lastAttempt = millis();
+    if (!client.connect(host, port, OUTPUT_CONNECT_TIMEOUT))
+    {
+        return false;
+    }
+    Serial.printf("Connected to %s:%u\n", host, port);
+    client.setNoDelay(true);
+    return true;
+}
+void pushRotatorTarget()
+{
+    // Push mode: sends "P az el" to the rotctld at ROTATOR_PUSH_HOST, ROTATOR_LEAD_MS ahead of time
+    static unsigned long lastAttempt = 0;
+    static unsigned long lastPush = 0;
+    static double pushedAzimuth = NAN;
+    static double pushedElevation = NAN;
+    if (ROTATOR_PUSH_HOST[0] == 0)
     {
-        calibrateTFTscreen();
         return;
     }
-
-    uint16_t calibrationData[5];
-    preferences.begin("TFT", true);
-    bool dataValid = true;
-
-    for (int i = 0; i < 5; i++)
+    if (!rotatorPush.connected())
     {
-        calibrationData[i] = preferences.getUInt(("calib" + String(i)).c_str(), 0xFFFF);
-        if (calibrationData[i] == 0xFFFF)
+        pushedAzimuth = NAN; // Send the first target right away
+        if (!connectOutput(rotatorPush, ROTATOR_PUSH_HOST, ROTATOR_PUSH_PORT, lastAttempt))
         {
-            dataValid = false;
+            return;
         }
     }
-    preferences.end();
-
-    if (dataValid)
+    while (rotatorPush.available() > 0)
     {
-        tft.setTouch(calibrationData);
-        Serial.println("Calibration data applied.");
+        rotatorPush.read(); // "RPRT 0" replies
     }
-    else
+    if (millis() - lastPush < ROTATOR_PUSH_INTERVAL)
     {
-        Serial.println("Invalid calibration data. Recalibrating...");
-        calibrateTFTscreen();
+        return;
+    }
+    lastPush = millis();
+    double azimuth, elevation;
+    rotatorTarget(fractionalUnixtime() + ROTATOR_LEAD_MS / 1000.0, azimuth, elevation);
+    if (fabs(azimuth - pushedAzimuth) < ROTATOR_PUSH_STEP && fabs(elevation - pushedElevation) < ROTATOR_PUSH_STEP)
+    {
+        return;
     }
+    char command[40];
+    snprintf(command, sizeof(command), "P %.2f %.2f\n", azimuth, elevation);
+    rotatorPush.write((const uint8_t *)command, strlen(command));
+    pushedAzimuth = azimuth;
+    pushedElevation = elevation;
 }
-void drawSpeakerON(int x, int y)
-{ // Clear the previous display area with a black rectangle
-    int width = 30;
-    int height = 30;
-    tft.fillRect(x, y, width, height, TFT_BLACK);
-
-    // tft.drawRect(x - 30, y - 30, width + 60, height + 60, TFT_YELLOW); //touch rectangle
-    // Function to draw a bold line
-    auto drawBoldLine = [&](int x0, int y0, int x1, int y1, uint16_t color, int thickness)
+void serviceRotator()
+{
+    // Accepts rotctld clients and answers the complete lines they sent, without waiting for more data
+    if (rotctldServer.hasClient())
     {
-        for (int i = -thickness / 2; i <= thickness / 2; i++)
+        int slot = 0;
+        while (slot < ROTCTLD_CLIENTS_MAX && rotctldClients[slot].client.connected())
         {
-            tft.drawLine(x0 + i, y0, x1 + i, y1, color);
-            tft.drawLine(x0, y0 + i, x1, y1 + i, color);
+            slot++;
         }
-    };
-
-    float scale = 1.1; // Scaling factor
-    int thickness = 1; // Line thickness
-
-    // Semi-transparent filled shape (speaker body)
-    tft.fillTriangle(
-        x + scale * 13, y + scale * 3,
-        x + scale * 7, y + scale * 8,
-        x + scale * 5, y + scale * 8,
-        TFT_DARKGREY);
-
-    // Main outline of the speaker
-    drawBoldLine(x + scale * 13, y + scale * 3, x + scale * 7, y + scale * 8, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 7, y + scale * 8, x + scale * 5, y + scale * 8, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 5, y + scale * 8, x + scale * 3, y + scale * 10, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 3, y + scale * 10, x + scale * 3, y + scale * 14, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 3, y + scale * 14, x + scale * 5, y + scale * 16, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 5, y + scale * 16, x + scale * 7, y + scale * 16, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 7, y + scale * 16, x + scale * 13, y + scale * 21, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 13, y + scale * 21, x + scale * 13, y + scale * 3, TFT_WHITE, thickness);
-
-    // Curved sound waves
-    drawBoldLine(x + scale * 16, y + scale * 9, x + scale * 17, y + scale * 12, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 17, y + scale * 12, x + scale * 16, y + scale * 15, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 19, y + scale * 6, x + scale * 20, y + scale * 12, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 20, y + scale * 12, x + scale * 19, y + scale * 18, TFT_WHITE, thickness);
+        if (slot < ROTCTLD_CLIENTS_MAX)
+        {
+            rotctldClients[slot].client = rotctldServer.accept();
+            rotctldClients[slot].client.setNoDelay(true);
+            rotctldClients[slot].length = 0;
+        }
+        else
+        {
+            rotctldServer.accept().stop(); // All slots busy
+        }
+    }
+    for (int i = 0; i < ROTCTLD_CLIENTS_MAX; i++)
+    {
+        RotctldClient &connection = rotctldClients[i];
+        while (connection.client.connected() && connection.client.available() > 0)
+        {
+            char c = connection.client.read();
+            if (c == '\n')
+            {
+                connection.line[connection.length] = 0;
+                connection.length = 0;
+                rotctldCommand(connection.client, connection.line);
+            }
+            else if (c != '\r' && connection.length < (int)sizeof(connection.line) - 1)
+            {
+                connection.line[connection.length++] = c;
+            }
+        }
+    }
+    pushRotatorTarget();
 }
-void drawSpeakerOFF(int x, int y)
+void findTransponder()
 {
-    // Clear the previous display area with a black rectangle
-    int width = 30;
-    int height = 30;
-    tft.fillRect(x, y, width, height, TFT_BLACK);
-
-    // Function to draw a bold line
-    auto drawBoldLine = [&](int x0, int y0, int x1, int y1, uint16_t color, int thickness)
+    // Entry of TRANSPONDERS for the tracked satellite, none means no Doppler output
+    transponder = NULL;
+    for (size_t i = 0; i < sizeof(TRANSPONDERS) / sizeof(TRANSPONDERS[0]); i++)
     {
-        for (int i = -thickness / 2; i <= thickness / 2; i++)
+        if (TRANSPONDERS[i].catalogueNumber == satelliteCatalogueNumber)
         {
-            tft.drawLine(x0 + i, y0, x1 + i, y1, color);
-            tft.drawLine(x0, y0 + i, x1, y1 + i, color);
+            transponder = &TRANSPONDERS[i];
         }
-    };
-
-    float scale = 1.2; // Scaling factor
-    int thickness = 1; // Line thickness
-
-    // Semi-transparent filled shape (speaker body)
-    tft.fillTriangle(
-        x + scale * 13, y + scale * 3,
-        x + scale * 7, y + scale * 8,
-        x + scale * 5, y + scale * 8,
-        TFT_DARKGREY);
-
-    // Main outline of the speaker
-    drawBoldLine(x + scale * 13, y + scale * 3, x + scale * 7, y + scale * 8, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 7, y + scale * 8, x + scale * 5, y + scale * 8, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 5, y + scale * 8, x + scale * 3, y + scale * 10, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 3, y + scale * 10, x + scale * 3, y + scale * 14, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 3, y + scale * 14, x + scale * 5, y + scale * 16, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 5, y + scale * 16, x + scale * 7, y + scale * 16, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 7, y + scale * 16, x + scale * 13, y + scale * 21, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 13, y + scale * 21, x + scale * 13, y + scale * 3, TFT_WHITE, thickness);
-
-    // Cross lines
-    drawBoldLine(x + scale * 16, y + scale * 9, x + scale * 22, y + scale * 15, TFT_WHITE, thickness);
-    drawBoldLine(x + scale * 22, y + scale * 9, x + scale * 16, y + scale * 15, TFT_WHITE, thickness);
+    }
+    if (transponder == NULL)
+    {
+        Serial.printf("No transponder known for satellite %d, Doppler output disabled\n", satelliteCatalogueNumber);
+        return;
+    }
+    Serial.printf("Transponder %s: uplink %.4f MHz, downlink %.4f MHz\n", transponder->name, transponder->uplinkMHz, transponder->downlinkMHz);
 }
-void webSocketEvent(uint8_t num, WStype_t type, uint8_t *payload, size_t length)
+void serviceDoppler()
 {
-    switch (type)
+    // Sends the Doppler corrected frequencies to the rigctld at RIGCTLD_HOST, DOPPLER_RATE times per second
+    // during the pass: "F <Hz>" for the downlink and "I <Hz>" (split TX) for the uplink, each only when it changed.
+    // Split operation is turned on with "S 1 VFOB" once per connection, for transponders with an uplink.
+    // The range rate is read from the pass ephemeris, a few multiply-adds per update.
+    static unsigned long lastAttempt = 0;
+    static unsigned long lastUpdate = 0;
+    static long sentDownlink = 0;
+    static long sentUplink = 0;
+    if (RIGCTLD_HOST[0] == 0 || transponder == NULL)
     {
-    case WStype_CONNECTED:
-        Serial.printf("Client %u connected\n", num);
-        break;
-    case WStype_DISCONNECTED:
-        Serial.printf("Client %u disconnected\n", num);
-        break;
-    case WStype_TEXT:
-        Serial.printf("Client %u sent: %s\n", num, payload);
-        break;
+        return;
+    }
+    if (!rigctld.connected())
+    {
+        sentDownlink = 0; // Send both frequencies again after a reconnection
+        sentUplink = 0;
+        if (!connectOutput(rigctld, RIGCTLD_HOST, RIGCTLD_PORT, lastAttempt))
+        {
+            return;
+        }
+        if (transponder->uplinkMHz > 0)
+        {
+            const char *split = "S 1 VFOB\n"; // Split on, transmit on VFO B
+            rigctld.write((const uint8_t *)split, strlen(split));
+        }
+    }
+    while (rigctld.available() > 0)
+    {
+        rigctld.read(); // "RPRT 0" replies
+    }
+    unsigned long interval = 1000 / constrain(DOPPLER_RATE, 0.2, 10.0);
+    if (millis() - lastUpdate < interval)
+    {
+        return;
+    }
+    lastUpdate = millis();
+    if (!passEphemeris.evaluate(getJulianFromUnix(fractionalUnixtime())))
+    {
+        return; // Outside the pass window
+    }
+    // Both ways, what is received is f (1 - v/c) of the frequency f sent, v being the range rate (positive when
+    // the satellite moves away): the downlink is heard lower, the uplink is sent higher to reach the transponder
+    double factor = passEphemeris.satRangeRate / SPEED_OF_LIGHT;
+    char command[32];
+    long downlink = lround(transponder->downlinkMHz * 1e6 * (1 - factor));
+    if (transponder->downlinkMHz > 0 && downlink != sentDownlink)
+    {
+        snprintf(command, sizeof(command), "F %ld\n", downlink);
+        rigctld.write((const uint8_t *)command, strlen(command));
+        sentDownlink = downlink;
+    }
+    long uplink = lround(transponder->uplinkMHz * 1e6 / (1 - factor));
+    if (transponder->uplinkMHz > 0 && uplink != sentUplink)
+    {
+        snprintf(command, sizeof(command), "I %ld\n", uplink);
+        rigctld.write((const uint8_t *)command, strlen(command));
+        sentUplink = uplink;
     }
 }
 void startWebSocket()
@@ -2998,6 +4953,19 @@ void startWebSocket()
     TFTprint("Test it with 'Simple WebSocket Client'", TFT_WHITE);
     TFTprint("(Chrome Extension)", TFT_WHITE);
 }
+void startRotctld()
+{
+    rotctldServer.begin();
+    rotctldServer.setNoDelay(true);
+    Serial.printf("Rotator (rotctld) server on port %u, test it with: rotctl -m 2 -r %s:%u p\n", ROTCTLD_PORT,
+                  WiFi.localIP().toString().c_str(), ROTCTLD_PORT);
+    TFTprint("");
+    TFTprint("Rotator (rotctld) on port " + String(ROTCTLD_PORT), TFT_YELLOW);
+    if (ROTATOR_PUSH_HOST[0] != 0)
+    {
+        TFTprint("Pushing targets to " + String(ROTATOR_PUSH_HOST), TFT_WHITE);
+    }
+}
 void setup()
 {
     if (DEBUG_ON_TFT)
@@ -3026,10 +4994,13 @@ void setup()
     displayUsedElements();
     delay(bootingMessagePause);
     startWebSocket();
+    startRotctld();
     delay(bootingMessagePause);
 
     sat.init(SatNameCharArray, TLEline1CharArray, TLEline2CharArray);
     sat.site(OBSERVER_LATITUDE, OBSERVER_LONGITUDE, OBSERVER_ALTITUDE);
+    passPredictor.begin(MIN_ELEVATION);
+    findTransponder();
 
     if (beepsNotificationBeforeAOSandLOS == 0)
     {
@@ -3039,7 +5010,7 @@ void setup()
     tft.fillScreen(TFT_BLACK);
 
     unixtime = timeClient.getEpochTime(); // Get the current UNIX timestamp
-    calculateNextPass();
+    updatePassState();                    // First pass calculation (state is IDLE)
     displayMainPage();
 
     // displayAzElPlotPage();
@@ -3063,8 +5034,12 @@ void loop()
     int deltaSeconds = -2500;
     unixtime = unixtime + deltaHour * 3600 + deltaMin * 60 + deltaSeconds;
 
+    uint32_t loopStart = micros();
+
     // get new sat data
-    sat.findsat(unixtime);
+    updateSatPosition();
+    // recalculate the next pass only when needed
+    updatePassState();
     // calculate orbit number
     getOrbitNumber(unixtime);
 
@@ -3234,17 +5209,17 @@ void loop()
         //  Check if 5 seconds (5000 ms) have passed since the last refresh
         if (millis() - AzElPlotlastRefreshTime >= 15000)
         {
-            displayAzElPlotPage();              // Refresh the display
+            displayAzElPlotPage(false);         // Refresh the plot area only
             AzElPlotlastRefreshTime = millis(); // Update the last refresh time
         }
     }
 
     if (touchCounter == 3) // Polar Plot
     {
-        // Check if 5 seconds (5000 ms) have passed since the last refresh
-        if (millis() - PolarPlotlastRefreshTime >= 15000)
+        // Check if 1 second has passed since the last refresh, only the marker moves
+        if (millis() - PolarPlotlastRefreshTime >= 1000)
         {
-            displayPolarPlotPage();              // Refresh the display
+            displayPolarPlotPage(false);         // Move the position marker only
             PolarPlotlastRefreshTime = millis(); // Update the last refresh time
         }
     }
@@ -3254,31 +5229,26 @@ void loop()
         // Check if 5 seconds (5000 ms) have passed since the last refresh
         if (millis() - multipassMaplastRefreshTime >= 5000)
         {
-            displayMapWithMultiPasses();            // Refresh the display
+            displayMapWithMultiPasses(false);       // Restore the overlays and draw them again
             multipassMaplastRefreshTime = millis(); // Update the last refresh time
         }
     }
     //--------------------------------------------------------------------------------
     // Process WebSocket events
     webSocket.loop();
+    serviceTelemetry();
+    serviceRotator();
+    serviceDoppler();
 
     static unsigned long lastLoopTime = millis();
     if (millis() - lastLoopTime >= 1000 && touchCounter == 1)
     {
         displayMainPage();
         lastLoopTime = millis();
-        String data = String("{\"satName\":\"") + sat.satName + "\"," +
-                      "\"time\":\"" + formatTimeOnly(unixtime, true) + "\"," +
-                      "\"altitude\":" + sat.satAlt + "," +
-                      "\"azimuth\":" + sat.satAz + "," +
-                      "\"elevation\":" + sat.satEl + "," +
-                      "\"latitude\":" + sat.satLat + "," +
-                      "\"longitude\":" + sat.satLon + "," +
-                      "\"distance\":" + sat.satDist + "," +
-                      "\"sunAzimuth\":" + sat.sunAz + "," +
-                      "\"sunElevation\":" + sat.sunEl + "}";
-
-        webSocket.broadcastTXT(data); // Send the JSON data over WebSocket
     }
     refreshBecauseReturningFromOtherPage = false;
+
+    loopBusyMicros += micros() - loopStart;
+    loopCount++;
+    reportLoopTiming();
 }
@@ -0,0 +1,193 @@
+"""
+Converts the embedded PNG images to a display native format, so that drawing them needs no zlib inflate.
+
+  python tools/assets.py            (from the ESP32-ISS-Tracker folder)
+
+It also runs as a PlatformIO pre script (extra_scripts = pre:tools/assets.py) and only regenerates
+outdated assets. The sources are the PNG byte arrays in src/*.h, the output is src/assets/<name>Rle.h
+with a const uint8_t <name>Rle[] array, drawn by drawRleImage() in main.cpp.
+
+Asset layout, 16-bit values little endian:
+  0  'R' 'L'    magic
+  2  format     RLE_RAW (0): RGB565 pixels
+                RLE_RGB565 (1): RGB565 packets
+                RLE_PALETTE (2): palette + 8-bit index packets
+  3  0          reserved
+  4  width
+  6  height
+  8  palette entries (RLE_PALETTE only, otherwise 0)
+  10 palette, RGB565, then the pixel data
+Colors are RGB565 in display byte order (big endian), like PNGdec's PNG_RGB565_BIG_ENDIAN.
+Each row is encoded on its own. A packet header h < 0x80 is followed by h + 1 literal pixels,
+h >= 0x80 by one pixel repeated (h & 0x7f) + 1 times.
+
+Trading flash for speed is per asset, in ASSETS below: "raw" is the fastest to draw and the largest,
+"rle" and "palette" are smaller, "png" keeps the PNG (no file is generated).
+"""
+
+import os
+import re
+import struct
+import sys
+import zlib
+
+# source header, array name, format
+# ISSsplashImage.h and blueMap.h are not listed: main.cpp never draws them, a converted copy would only cost build time.
+ASSETS = [
+    ("worldMap.h", "worldMap", "rle"),
+    ("fancySplashImage.h", "fancySplash", "rle"),
+    ("expedition72.h", "expedition72", "rle"),
+]
+
+RLE_RAW = 0
+RLE_RGB565 = 1
+RLE_PALETTE = 2
+
+
+def read_png_array(path, name):
+    # Bytes of "static const byte <name>[] PROGMEM = { 0x89, ... };"
+    with open(path) as f:
+        text = f.read()
+    match = re.search(r"\b" + re.escape(name) + r"\s*\[\s*\]\s*PROGMEM\s*=\s*\{(.*?)\}", text, re.S)
+    if match is None:
+        raise ValueError("%s: array %s not found" % (path, name))
+    return bytes(int(value, 16) for value in re.findall(r"0x([0-9a-fA-F]{1,2})", match.group(1)))
+
+
+def decode_png(data):
+    # 8-bit truecolor or truecolor + alpha, non interlaced; returns width, height, rows of RGB565
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError("not a PNG")
+    pos = 8
+    idat = b""
+    while pos < len(data):
+        length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if kind == b"IHDR":
+            width, height, depth, colortype, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+        elif kind == b"IDAT":
+            idat += chunk
+        elif kind == b"IEND":
+            break
+    if depth != 8 or colortype not in (2, 6) or interlace != 0:
+        raise ValueError("only 8-bit RGB/RGBA non interlaced PNGs are supported")
+    bpp = 4 if colortype == 6 else 3
+    stride = width * bpp
+    raw = zlib.decompress(idat)
+    rows = []
+    previous = bytearray(stride)
+    pos = 0
+    for _ in range(height):
+        kind = raw[pos]
+        line = bytearray(raw[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        for i in range(stride):
+            left = line[i - bpp] if i >= bpp else 0
+            up = previous[i]
+            upleft = previous[i - bpp] if i >= bpp else 0
+            if kind == 1:
+                line[i] = (line[i] + left) & 0xff
+            elif kind == 2:
+                line[i] = (line[i] + up) & 0xff
+            elif kind == 3:
+                line[i] = (line[i] + ((left + up) >> 1)) & 0xff
+            elif kind == 4:
+                p = left + up - upleft
+                pa, pb, pc = abs(p - left), abs(p - up), abs(p - upleft)
+                predictor = left if pa <= pb and pa <= pc else (up if pb <= pc else upleft)
+                line[i] = (line[i] + predictor) & 0xff
+        rows.append([((line[i] & 0xf8) << 8) | ((line[i + 1] & 0xfc) << 3) | (line[i + 2] >> 3)
+                     for i in range(0, stride, bpp)])
+        previous = line
+    return width, height, rows
+
+
+def encode_row(row, pixel, minrun):
+    # Packets of one row, pixel(value) returns the bytes of a pixel
+    out = bytearray()
+    literal = []
+    i = 0
+    while i < len(row):
+        run = 1
+        while i + run < len(row) and run < 128 and row[i + run] == row[i]:
+            run += 1
+        if run >= minrun:
+            while literal:
+                out.append(len(literal[:128]) - 1)
+                for value in literal[:128]:
+                    out += pixel(value)
+                literal = literal[128:]
+            out.append(0x80 | (run - 1))
+            out += pixel(row[i])
+            i += run
+        else:
+            literal.append(row[i])
+            i += 1
+    while literal:
+        out.append(len(literal[:128]) - 1)
+        for value in literal[:128]:
+            out += pixel(value)
+        literal = literal[128:]
+    return out
+
+
+def encode(width, height, rows, kind):
+    rgb565 = lambda value: struct.pack(">H", value)  # display byte order
+    palette = []
+    if kind == "palette":
+        palette = sorted(set(value for row in rows for value in row))
+        if len(palette) > 256:
+            print("  %d colors, too many for a palette, using rle" % len(palette))
+            kind = "rle"
+            palette = []
+    if kind == "raw":
+        data = b"".join(rgb565(value) for row in rows for value in row)
+        fmt = RLE_RAW
+    elif kind == "rle":
+        data = b"".join(encode_row(row, rgb565, 2) for row in rows)
+        fmt = RLE_RGB565
+    else:
+        index = dict((value, i) for i, value in enumerate(palette))
+        data = b"".join(encode_row([index[value] for value in row], lambda value: bytes([value]), 3) for row in rows)
+        fmt = RLE_PALETTE
+    header = struct.pack("<2sBBHHH", b"RL", fmt, 0, width, height, len(palette))
+    return header + b"".join(rgb565(value) for value in palette) + data
+
+
+def write_header(path, name, blob, source):
+    with open(path, "w") as f:
+        f.write("// Generated by tools/assets.py from %s, do not edit\n" % source)
+        f.write("// array size is %d\n" % len(blob))
+        f.write("static const uint8_t %s[] PROGMEM = {\n" % name)
+        for i in range(0, len(blob), 16):
+            f.write("  " + ", ".join("0x%02x" % value for value in blob[i:i + 16]) + ",\n")
+        f.write("};\n")
+
+
+def build(project):
+    src = os.path.join(project, "src")
+    outdir = os.path.join(src, "assets")
+    for source, name, kind in ASSETS:
+        output = os.path.join(outdir, name + "Rle.h")
+        if kind == "png":
+            if os.path.exists(output):
+                os.remove(output)  # Back to the PNG
+            continue
+        inputs = [os.path.join(src, source), os.path.abspath(__file__)]
+        if os.path.exists(output) and os.path.getmtime(output) >= max(os.path.getmtime(p) for p in inputs):
+            continue
+        png = read_png_array(os.path.join(src, source), name)
+        width, height, rows = decode_png(png)
+        blob = encode(width, height, rows, kind)
+        if not os.path.isdir(outdir):
+            os.makedirs(outdir)
+        write_header(output, name + "Rle", blob, source)
+        print("assets: %s %dx%d %s, %d bytes (PNG %d bytes)" % (name, width, height, kind, len(blob), len(png)))
+
+
+if __name__ == "__main__":
+    build(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+elif "SCons" in sys.modules:
+    Import("env")  # noqa: F821, PlatformIO pre script
+    build(env.subst("$PROJECT_DIR"))  # noqa: F821